@@ -1,5 +1,7 @@
 import os
+import json
 import argparse
+import subprocess
 from bs4 import BeautifulSoup
 
 cwd = os.getcwd()
@@ -28,6 +30,16 @@ argParser.add_argument('-i', '--input', type=str,
                        default=cwd, help='input directory')
 argParser.add_argument('-o', '--output', type=str,
                        default=cwd, help='output directory')
+argParser.add_argument('-p', '--profile', choices=['raf', 'asyncify'], default='raf',
+                       help='raf: no ASYNCIFY, main loop on requestAnimationFrame; asyncify: old 60 fps timer loop')
+argParser.add_argument('-O', '--opt', choices=['Os', 'O3'], default='Os',
+                       help='optimize for size (Os) or speed (O3)')
+argParser.add_argument('-m', '--measure', action='store_true',
+                       help='measure the frame time headlessly with node measureWASM.js')
+argParser.add_argument('-t', '--memtrack', action='store_true',
+                       help='track heap usage by category (debug overlay, peak reported by --measure)')
+argParser.add_argument('--heap', type=str, default='67108864',
+                       help='initial linear memory in bytes, or auto to use the peak measured by a --memtrack --measure build')
 args = vars(argParser.parse_args())
 
 inputPath = os.path.join(args['input'], 'main.c')
@@ -38,10 +50,71 @@ outputPath = os.path.join(args['output'], 'game.html')
 
 # Build WASM
 raylibSrcDir = 'C:/raylib/raylib/src'
-compilerArgs = "-Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Os -I. -I {0} -I {0}/external -L. -L {0} -s USE_GLFW=3 -s ASYNCIFY -s TOTAL_MEMORY=67108864 -s ALLOW_MEMORY_GROWTH=1 -s FORCE_FILESYSTEM=1 --shell-file ./src/shell.html {0}/web/libraylib.a -DPLATFORM_WEB -s EXPORTED_FUNCTIONS=[\"_free\",\"_malloc\",\"_main\"] -s EXPORTED_RUNTIME_METHODS=ccall".format(
-    raylibSrcDir)
+profileArgs = {
+    # emscripten_set_main_loop() already yields to the browser, so ASYNCIFY is only kept for comparison
+    'raf': '-DWEB_TARGET_FPS=0',
+    'asyncify': '-s ASYNCIFY -DWEB_TARGET_FPS=60',
+}[args['profile']]
+
+# Size the initial memory from the measured high water mark, rounded up to whole 64 KiB wasm pages with some headroom
+reportPath = os.path.join(args['output'], 'build_report.json')
+initialMemory = args['heap']
+if initialMemory == 'auto':
+    measured = [entry['memHighWater'] for entry in json.load(open(reportPath)).values() if 'memHighWater' in entry] \
+        if os.path.exists(reportPath) else []
+    if not measured:
+        print('No measured peak in {}, build once with --memtrack --measure first'.format(reportPath))
+        exit(0)
+    page = 65536
+    initialMemory = str((int(max(measured) * 1.1) + page - 1) // page * page)
+    print('Initial memory sized to {} bytes'.format(initialMemory))
+exportedFunctions = '"_free","_malloc","_main"'
+if args['memtrack']:
+    # Wrap the allocator for raylib's code too, see src/memtrack.h
+    profileArgs += ' -DMEMTRACK -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free'
+    exportedFunctions += ',"_GetMemPeak","_GetMemHighWater"'
+compilerArgs = "-Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -{1} -I. -I {0} -I {0}/external -L. -L {0} -s USE_GLFW=3 {2} -s INITIAL_MEMORY={3} -s ALLOW_MEMORY_GROWTH=1 -s FORCE_FILESYSTEM=1 --shell-file ./src/shell.html {0}/web/libraylib.a -DPLATFORM_WEB -s EXPORTED_FUNCTIONS=[{4}] -s EXPORTED_RUNTIME_METHODS=ccall".format(
+    raylibSrcDir, args['opt'], profileArgs, initialMemory, exportedFunctions)
 build_cmd = "emcc {} -o {} {} --preload-file src/resources/@resources/".format(inputPath, outputPath, compilerArgs)
-os.system(build_cmd)
+if os.system(build_cmd) != 0:
+    print('emcc failed, see its output above')
+    exit(1)
+
+# Report code size and frame time, compared with the other profiles built into the same directory
+outputBase = os.path.splitext(outputPath)[0]
+report = {}
+if os.path.exists(reportPath):
+    with open(reportPath, 'r') as f:
+        report = json.load(f)
+key = '{}-{}{}'.format(args['profile'], args['opt'], '-memtrack' if args['memtrack'] else '')
+entry = {'wasm': os.path.getsize(outputBase + '.wasm'), 'js': os.path.getsize(outputBase + '.js')}
+if args['measure']:
+    try:
+        result = subprocess.run(['node', os.path.join(cwd, 'measureWASM.js'), args['output']], capture_output=True, text=True)
+    except FileNotFoundError:
+        print('node not found, --measure needs it on the PATH')
+        exit(1)
+    # The last line of a successful run is the JSON summary
+    lines = result.stdout.strip().splitlines()
+    try:
+        if result.returncode != 0 or not lines:
+            raise ValueError('exit code {}'.format(result.returncode))
+        entry.update(json.loads(lines[-1]))
+    except ValueError as e:  # json.JSONDecodeError is a ValueError
+        print('measureWASM.js failed ({}):'.format(e))
+        print(result.stderr.strip() or result.stdout.strip())
+        exit(1)
+report[key] = entry
+with open(reportPath, 'w') as f:
+    json.dump(report, f, indent=4)
+for name, other in report.items():
+    line = '{:<14} wasm {:>9} B ({:+d})  js {:>8} B ({:+d})'.format(
+        name, other['wasm'], other['wasm'] - entry['wasm'], other['js'], other['js'] - entry['js'])
+    if 'meanMs' in other and 'meanMs' in entry:
+        line += '  frame {:.3f} ms ({:+.3f})'.format(other['meanMs'], other['meanMs'] - entry['meanMs'])
+    if 'memPeak' in other:
+        line += '  heap peak {} B  high water {} B'.format(other['memPeak'], other['memHighWater'])
+    print(line)
 
 # Change name and color in .html
 with open(outputPath, 'r') as f:
@@ -0,0 +1,182 @@
+// Runs a WASM build headlessly under Node with a stub canvas and reports the average frame time.
+// Usage: node measureWASM.js <dir containing game.js> [frames]
+// Every WebGL call is a no-op, so the time measured is the CPU cost of one frame of game logic and draw batching.
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const outDir = path.resolve(process.argv[2] || '.');
+const numFrames = parseInt(process.argv[3] || '600');
+const warmupFrames = 60;
+
+// WebGL stub, answers the queries raylib makes during init and ignores everything else
+const GL_CONSTANTS = { VERSION: 0x1F02, VENDOR: 0x1F00, RENDERER: 0x1F01, SHADING_LANGUAGE_VERSION: 0x8B8C };
+class WebGLRenderingContext { }
+global.WebGLRenderingContext = WebGLRenderingContext;
+function makeWebGL(canvas) {
+    const target = Object.assign(new WebGLRenderingContext(), {
+        canvas: canvas,
+        drawingBufferWidth: canvas.width,
+        drawingBufferHeight: canvas.height,
+        getParameter: (p) => {
+            if (p === GL_CONSTANTS.VERSION) return 'WebGL 1.0 (stub)';
+            if (p === GL_CONSTANTS.SHADING_LANGUAGE_VERSION) return 'WebGL GLSL ES 1.0 (stub)';
+            if (p === GL_CONSTANTS.VENDOR || p === GL_CONSTANTS.RENDERER) return 'stub';
+            return 4096;
+        },
+        getContextAttributes: () => ({ alpha: true, depth: true, stencil: false, antialias: true }),
+        getSupportedExtensions: () => [],
+        getExtension: () => null,
+        getShaderParameter: () => true,
+        getProgramParameter: (program, p) => (p === 0x8B86 || p === 0x8B89 ? 0 : true), // ACTIVE_UNIFORMS, ACTIVE_ATTRIBUTES
+        getShaderInfoLog: () => '',
+        getProgramInfoLog: () => '',
+        getAttribLocation: () => 0,
+        getUniformLocation: () => ({}),
+        getError: () => 0,
+        isContextLost: () => false,
+        checkFramebufferStatus: () => 0x8CD5, // FRAMEBUFFER_COMPLETE
+    });
+    return new Proxy(target, {
+        get: (t, key) => {
+            if (key in t) return t[key];
+            if (typeof key === 'string' && /^[A-Z_0-9]+$/.test(key)) return 0;
+            if (typeof key === 'string' && key.startsWith('create')) return () => ({});
+            return () => undefined;
+        },
+    });
+}
+
+function makeElement() {
+    return {
+        style: { setProperty: () => { }, removeProperty: () => { } },
+        width: 800,
+        height: 600,
+        clientWidth: 800,
+        clientHeight: 600,
+        addEventListener: () => { },
+        removeEventListener: () => { },
+        getBoundingClientRect: () => ({ left: 0, top: 0, width: 800, height: 600 }),
+        setAttribute: () => { },
+        focus: () => { },
+        requestPointerLock: () => { },
+    };
+}
+
+const canvas = makeElement();
+canvas.getContext = (type) => (type === 'webgl' || type === 'experimental-webgl' || type === 'webgl2' ? makeWebGL(canvas) : null);
+
+// Drive requestAnimationFrame and setTimeout main loops the same way and time every frame callback
+const frameTimes = [];
+let pending = null;
+let animationFrameLoop = false;
+function scheduleFrame(callback) {
+    pending = callback;
+    return 1;
+}
+
+// The main loop falls back to setTimeout when built with a fixed fps. Its runner is recognised by the call pattern
+// rather than by its name, which changes between emscripten releases: it is the callback that is handed to setTimeout
+// again once it ran. From then on it goes through the same scheduler as requestAnimationFrame.
+const realSetTimeout = setTimeout;
+const timeoutCallbacks = new WeakSet();
+let timeoutLoop = null;
+global.setTimeout = (callback, delay, ...args) => {
+    if (typeof callback === 'function' && !animationFrameLoop) {
+        if (callback === timeoutLoop || timeoutCallbacks.has(callback)) {
+            timeoutLoop = callback;
+            return scheduleFrame(callback);
+        }
+        timeoutCallbacks.add(callback);
+    }
+    return realSetTimeout(callback, delay, ...args);
+};
+
+global.window = global;
+global.window.addEventListener = () => { };
+global.window.removeEventListener = () => { };
+global.window.matchMedia = () => ({ matches: false, addEventListener: () => { }, removeEventListener: () => { }, addListener: () => { } });
+global.window.devicePixelRatio = 1;
+global.document = {
+    hidden: false,
+    visibilityState: 'visible',
+    querySelector: () => canvas,
+    getElementById: () => canvas,
+    createElement: () => makeElement(),
+    addEventListener: () => { },
+    removeEventListener: () => { },
+    body: makeElement(),
+    documentElement: makeElement(),
+};
+// One standard-mapping gamepad holding LB with the right stick pushed, so the wheel is drawn every frame
+const gamepad = {
+    id: 'stub', index: 0, connected: true, mapping: 'standard', timestamp: 0,
+    buttons: Array.from({ length: 17 }, (_, i) => ({ pressed: i === 4, touched: i === 4, value: i === 4 ? 1 : 0 })),
+    axes: [0, 0, 1, 0],
+};
+Object.defineProperty(global, 'navigator', {
+    value: { userAgent: 'node', getGamepads: () => [gamepad] },
+    configurable: true,
+});
+global.location = { pathname: '/game.html', href: 'file:///game.html', search: '', hash: '' };
+global.screen = { width: 800, height: 600 };
+global.requestAnimationFrame = (callback) => {
+    animationFrameLoop = true;
+    return scheduleFrame(callback);
+};
+global.cancelAnimationFrame = () => { pending = null; };
+global.alert = (msg) => console.log(msg);
+global.Module = {
+    canvas: canvas,
+    print: () => { },
+    printErr: () => { },
+    locateFile: (file) => path.join(outDir, file),
+    onRuntimeInitialized: () => setImmediate(() => waitForMainLoop(performance.now())),
+};
+
+// A setTimeout loop is only recognised after its first tick, give it time before measuring
+const mainLoopWaitMs = 2000;
+function waitForMainLoop(startMs) {
+    if (pending !== null) {
+        runFrames();
+        return;
+    }
+    if (performance.now() - startMs > mainLoopWaitMs) {
+        console.log('No main loop found: nothing called requestAnimationFrame or rescheduled itself with setTimeout');
+        process.exit(1);
+    }
+    realSetTimeout(() => waitForMainLoop(startMs), 5);
+}
+
+function runFrames() {
+    for (let i = 0; i < warmupFrames + numFrames; i++) {
+        if (pending === null) {
+            console.log('Main loop did not schedule a frame');
+            process.exit(1);
+        }
+        const callback = pending;
+        pending = null;
+        const start = process.hrtime.bigint();
+        callback(performance.now());
+        const elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+        if (i >= warmupFrames)
+            frameTimes.push(elapsed);
+    }
+    frameTimes.sort((a, b) => a - b);
+    const mean = frameTimes.reduce((a, b) => a + b, 0) / frameTimes.length;
+    const p95 = frameTimes[Math.floor(frameTimes.length * 0.95)];
+    const result = { frames: frameTimes.length, meanMs: mean, p95Ms: p95 };
+    // Builds with --memtrack export their heap peak
+    if (Module._GetMemPeak) {
+        result.memPeak = Module._GetMemPeak();
+        result.memHighWater = Module._GetMemHighWater();
+    }
+    console.log(JSON.stringify(result));
+    process.exit(0);
+}
+
+global.require = require;
+global.__dirname = outDir;
+process.chdir(outDir);
+vm.runInThisContext(fs.readFileSync(path.join(outDir, 'game.js'), 'utf8'), { filename: 'game.js' });
@@ -0,0 +1,200 @@
+// Micro-benchmarks for the wheel geometry in wheelmath.h
+// Reports ns/op for dense sweeps and checks every result against a long double reference.
+// Exits non-zero when a routine drifts from the reference, so faster versions can be swapped in safely.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <raylib.h>
+
+#include "./wheelmath.h"
+
+#define MIN_SEGMENTS 8
+#define MAX_SEGMENTS 64
+#define STICK_STEPS 512     // Stick positions per axis in the sweep
+#define REPEATS 20          // Sweeps per measurement
+#define ANGLE_TOLERANCE 1e-3 // Degrees
+#define PIXEL_TOLERANCE 1.5  // Pixels, button positions are truncated to whole pixels
+#define CENTER_TOLERANCE 1e-2 // Pixels, segment centers are not truncated
+#define MISMATCH_TOLERANCE 0.001 // Fraction of stick positions allowed to land in another segment (truncation at edges)
+
+static const Vector2 benchCenter = {400, 350};
+static const float benchRadius = 225;
+static volatile float sink;
+
+static double NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// High-precision references
+static long double RefStart(int i, int n) { return i * (360.0L / n) - (360.0L / n - WHEEL_SEGMENT_GAP) / 2.0L; }
+static long double RefEnd(int i, int n) { return i * (360.0L / n) + (360.0L / n - WHEEL_SEGMENT_GAP) / 2.0L; }
+
+// Icon center of segment i, from the reference angles alone
+static void RefSegmentCenter(int i, int n, long double *cx, long double *cy)
+{
+    long double mid = (RefStart(i, n) + RefEnd(i, n) - 180.0L) * acosl(-1.0L) / 360.0L;
+    *cx = benchCenter.x + cosl(mid) * benchRadius * 0.8L;
+    *cy = benchCenter.y - sinl(mid) * benchRadius * 0.8L;
+}
+
+static int RefStickToSegment(long double x, long double y, int n)
+{
+    if (sqrtl(x * x + y * y) <= 0.99L)
+        return -1;
+    long double angle = atan2l(y, x) * 180.0L / acosl(-1.0L) - 90.0L;
+    if (angle < 0)
+        angle += 360.0L;
+    angle = fabsl(truncl(360.0L - angle));
+    long double half = (360.0L / n - WHEEL_SEGMENT_GAP) / 2.0L;
+    int segment = -1;
+    for (int i = 0; i < n; i++)
+    {
+        if ((angle >= RefStart(i, n) && angle <= RefEnd(i, n)) || (i == 0 && angle > 360.0L - half && angle <= 360.0L))
+            segment = i;
+    }
+    return segment;
+}
+
+static void RefTriggerButtons(int i, int n, long double *ltx, long double *lty, long double *rtx, long double *rty)
+{
+    long double pi = acosl(-1.0L);
+    long double cx, cy;
+    RefSegmentCenter(i, n, &cx, &cy);
+    long double dy = cy - benchCenter.y;
+    long double inner = sqrtl(-dy * dy + powl(benchRadius * 0.625L, 2));
+    long double outer = sqrtl(-dy * dy + powl(benchRadius, 2));
+    if (isnan(inner))
+    {
+        long double start = RefStart(i, n), end = RefEnd(i, n);
+        long double ltAngle = (start >= 0 && start <= 180) ? start : end;
+        long double rtAngle = (start >= 0 && start <= 180) ? end : start;
+        *ltx = benchRadius * 0.8L * cosl((ltAngle + 90.0L) * pi / 180.0L) + benchCenter.x;
+        *lty = benchRadius * 0.8L * sinl((ltAngle + 90.0L) * pi / 180.0L) + benchCenter.y;
+        *rtx = benchRadius * 0.8L * cosl((rtAngle + 90.0L) * pi / 180.0L) + benchCenter.x;
+        *rty = benchRadius * 0.8L * sinl((rtAngle + 90.0L) * pi / 180.0L) + benchCenter.y;
+    }
+    else
+    {
+        long double sign = cx > benchCenter.x ? 1.0L : -1.0L;
+        *ltx = benchCenter.x + sign * (sign > 0 ? inner : outer);
+        *rtx = benchCenter.x + sign * (sign > 0 ? outer : inner);
+        *lty = *rty = cy;
+    }
+}
+
+static int BenchSegmentAngles(int n)
+{
+    float starts[MAX_SEGMENTS], ends[MAX_SEGMENTS];
+    Vector2 centers[MAX_SEGMENTS];
+    int iterations = REPEATS * 1000;
+
+    double start = NowNs();
+    for (int r = 0; r < iterations; r++)
+        sink = ComputeSegmentAngles(n, benchCenter, benchRadius, starts, ends, centers);
+    double nsPerOp = (NowNs() - start) / iterations;
+
+    double maxError = 0;
+    double maxCenterError = 0;
+    for (int i = 0; i < n; i++)
+    {
+        maxError = fmax(maxError, fabsl(starts[i] - RefStart(i, n)));
+        maxError = fmax(maxError, fabsl(ends[i] - RefEnd(i, n)));
+        long double cx, cy;
+        RefSegmentCenter(i, n, &cx, &cy);
+        maxCenterError = fmax(maxCenterError, fmax(fabsl(centers[i].x - cx), fabsl(centers[i].y - cy)));
+    }
+    bool ok = maxError <= ANGLE_TOLERANCE && maxCenterError <= CENTER_TOLERANCE;
+    printf("ComputeSegmentAngles  n=%-3d %10.2f ns/op  max error %.2e deg %.2e px  %s\n", n, nsPerOp, maxError,
+           maxCenterError, ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+static int BenchStickToSegment(int n)
+{
+    float starts[MAX_SEGMENTS], ends[MAX_SEGMENTS];
+    Vector2 centers[MAX_SEGMENTS];
+    float half = ComputeSegmentAngles(n, benchCenter, benchRadius, starts, ends, centers);
+
+    // Sweep the full square the stick can report, most positions land on the ring
+    double start = NowNs();
+    int sum = 0;
+    for (int r = 0; r < REPEATS; r++)
+    {
+        for (int yi = 0; yi < STICK_STEPS; yi++)
+        {
+            for (int xi = 0; xi < STICK_STEPS; xi++)
+            {
+                Vector2 stick = {-1.0f + 2.0f * xi / (STICK_STEPS - 1), -1.0f + 2.0f * yi / (STICK_STEPS - 1)};
+                sum += StickToSegment(stick, n, starts, ends, half);
+            }
+        }
+    }
+    double nsPerOp = (NowNs() - start) / ((double)REPEATS * STICK_STEPS * STICK_STEPS);
+    sink = sum;
+
+    int mismatches = 0;
+    for (int yi = 0; yi < STICK_STEPS; yi++)
+    {
+        for (int xi = 0; xi < STICK_STEPS; xi++)
+        {
+            Vector2 stick = {-1.0f + 2.0f * xi / (STICK_STEPS - 1), -1.0f + 2.0f * yi / (STICK_STEPS - 1)};
+            if (StickToSegment(stick, n, starts, ends, half) != RefStickToSegment(stick.x, stick.y, n))
+                mismatches++;
+        }
+    }
+    double mismatchFraction = (double)mismatches / (STICK_STEPS * STICK_STEPS);
+    bool ok = mismatchFraction <= MISMATCH_TOLERANCE;
+    printf("StickToSegment        n=%-3d %10.2f ns/op  %d mismatches  %s\n", n, nsPerOp, mismatches, ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+static int BenchTriggerButtons(int n)
+{
+    float starts[MAX_SEGMENTS], ends[MAX_SEGMENTS];
+    Vector2 centers[MAX_SEGMENTS];
+    ComputeSegmentAngles(n, benchCenter, benchRadius, starts, ends, centers);
+    int iterations = REPEATS * 1000;
+
+    Vector2 lt, rt;
+    double start = NowNs();
+    for (int r = 0; r < iterations; r++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            TriggerButtonAnchors(benchCenter, benchRadius, centers[i], starts[i], ends[i], &lt, &rt);
+            sink = lt.x + rt.y;
+        }
+    }
+    double nsPerOp = (NowNs() - start) / ((double)iterations * n);
+
+    double maxError = 0;
+    for (int i = 0; i < n; i++)
+    {
+        long double ltx, lty, rtx, rty;
+        TriggerButtonAnchors(benchCenter, benchRadius, centers[i], starts[i], ends[i], &lt, &rt);
+        RefTriggerButtons(i, n, &ltx, &lty, &rtx, &rty);
+        maxError = fmax(maxError, fmax(fabsl(lt.x - ltx), fabsl(lt.y - lty)));
+        maxError = fmax(maxError, fmax(fabsl(rt.x - rtx), fabsl(rt.y - rty)));
+    }
+    bool ok = maxError <= PIXEL_TOLERANCE;
+    printf("TriggerButtonAnchors  n=%-3d %10.2f ns/op  max error %.2f px  %s\n", n, nsPerOp, maxError, ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+int main(void)
+{
+    int failures = 0;
+    for (int n = MIN_SEGMENTS; n <= MAX_SEGMENTS; n *= 2)
+    {
+        failures += BenchSegmentAngles(n);
+        failures += BenchStickToSegment(n);
+        failures += BenchTriggerButtons(n);
+    }
+    printf("%d benchmark checks failed\n", failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,401 @@
+// Burst capture
+// Background frames are copied as they are shown, oriented by the tools switched on in the wheel, into a small
+// ring of BURST_SLOTS buffers allocated at the first burst, so capturing never allocates; a frame that finds every
+// slot still waiting is dropped and counted. A worker thread appends filled slots to one raw RGB file per burst,
+// which plays back with --source burst_NNNN.rgb:WxH and keeps up with the capture rate. PNG bursts are converted
+// from that file once it is complete, one frame at a time whenever no slot is waiting, since a PNG encode takes
+// longer than the capture interval. Web builds hand every finished file to saveFileFromMEMFSToDisk() in
+// shell.html; without pthreads they encode one frame on every tick without a capture and default to raw.
+
+#if !defined(PLATFORM_WEB) || defined(__EMSCRIPTEN_PTHREADS__)
+#define BURST_THREADED
+#include <pthread.h>
+#endif
+
+#define BURST_FRAMES 30     // Frames captured by one burst
+#define BURST_SLOTS 4       // Full frames in flight, 7.7 MB at 800x600
+#define BURST_FPS 30.0f     // Capture rate when the background is a still image
+#define MAX_PENDING_SAVES 8 // Finished files waiting to be handed to the browser
+#define MAX_PENDING_CONVERSIONS 4 // Finished PNG bursts waiting to be converted from their raw file
+
+typedef enum BurstFormat
+{
+    BURST_FORMAT_PNG = 0,
+    BURST_FORMAT_RAW
+} BurstFormat;
+
+#if defined(PLATFORM_WEB)
+#define DEFAULT_BURST_FORMAT BURST_FORMAT_RAW
+#else
+#define DEFAULT_BURST_FORMAT BURST_FORMAT_PNG
+#endif
+
+typedef enum CaptureSlotState
+{
+    CAPTURE_FREE = 0,
+    CAPTURE_FILLED,
+    CAPTURE_ENCODING
+} CaptureSlotState;
+
+typedef struct CaptureSlot
+{
+    unsigned char *pixels; // RGBA8
+    CaptureSlotState state;
+    unsigned int burst;
+    unsigned int frame; // Position in its burst
+    bool last;          // Last frame of its burst
+    BurstFormat format;
+} CaptureSlot;
+
+typedef struct BurstCapture
+{
+    CaptureSlot slots[BURST_SLOTS];
+    int width;
+    int height;
+    BurstFormat format;   // Of the current burst, copied into each slot so the worker never reads it
+    unsigned int burst;   // Number of the current burst
+    unsigned int frame;   // Frames captured in the current burst
+    int remaining;        // Frames still to capture in the current burst
+    unsigned int dropped; // Frames of the current burst lost because every slot was still waiting to be encoded
+    unsigned int unfinishedBurst; // Burst whose last frame was dropped, finished once its other frames are written
+    BurstFormat unfinishedFormat;
+    // Only touched by the encoder
+    unsigned int conversions[MAX_PENDING_CONVERSIONS]; // PNG bursts with a complete raw file, oldest first
+    int numConversions;
+    FILE *convertFile; // Raw file of conversions[0]
+    unsigned int convertFrame;
+    unsigned char *convertPixels; // One RGB frame
+    float timeAccumulator;
+    char pendingSaves[MAX_PENDING_SAVES][64];
+    int numPendingSaves;
+    bool running;
+    bool capturedThisTick; // Set by CaptureBurstFrame(), only read without a worker thread
+#if defined(BURST_THREADED)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t slotFilled;
+#endif
+} BurstCapture;
+
+static BurstCapture burstCapture = {0};
+
+static void LockBurst(BurstCapture *b)
+{
+#if defined(BURST_THREADED)
+    pthread_mutex_lock(&b->lock);
+#endif
+}
+
+static void UnlockBurst(BurstCapture *b)
+{
+#if defined(BURST_THREADED)
+    pthread_mutex_unlock(&b->lock);
+#endif
+}
+
+static void QueueBurstSave(BurstCapture *b, const char *fileName)
+{
+#if defined(PLATFORM_WEB)
+    LockBurst(b);
+    if (b->numPendingSaves < MAX_PENDING_SAVES)
+        snprintf(b->pendingSaves[b->numPendingSaves++], sizeof(b->pendingSaves[0]), "%s", fileName);
+    UnlockBurst(b);
+#endif
+}
+
+// The raw file of a burst is complete: hand it to the browser, or queue it to be converted to PNG files
+static void FinishBurstFile(BurstCapture *b, unsigned int burst, BurstFormat format)
+{
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "burst_%04u.rgb", burst);
+    if (format == BURST_FORMAT_RAW)
+        QueueBurstSave(b, fileName);
+    else if (b->numConversions < MAX_PENDING_CONVERSIONS)
+        b->conversions[b->numConversions++] = burst;
+    else
+        TraceLog(LOG_WARNING, "BURST: Too many bursts waiting to be converted, %s is kept raw", fileName);
+}
+
+// Append a slot to the raw file of its burst
+static void EncodeCaptureSlot(BurstCapture *b, CaptureSlot *slot)
+{
+    // Drop the alpha channel in place, the slot is rewritten by the next capture anyway
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "burst_%04u.rgb", slot->burst);
+    for (int i = 0; i < b->width * b->height; i++)
+    {
+        slot->pixels[i * 3 + 0] = slot->pixels[i * 4 + 0];
+        slot->pixels[i * 3 + 1] = slot->pixels[i * 4 + 1];
+        slot->pixels[i * 3 + 2] = slot->pixels[i * 4 + 2];
+    }
+    FILE *file = fopen(fileName, slot->frame == 0 ? "wb" : "ab");
+    if (file != NULL)
+    {
+        fwrite(slot->pixels, 1, b->width * b->height * 3, file);
+        fclose(file);
+    }
+    if (slot->last)
+        FinishBurstFile(b, slot->burst, slot->format);
+}
+
+// Encode the oldest filled slot, false if there was none
+static bool EncodeNextCapture(BurstCapture *b)
+{
+    CaptureSlot *slot = NULL;
+    LockBurst(b);
+    for (int i = 0; i < BURST_SLOTS; i++)
+    {
+        CaptureSlot *s = &b->slots[i];
+        if (s->state == CAPTURE_FILLED && (slot == NULL || s->burst < slot->burst || (s->burst == slot->burst && s->frame < slot->frame)))
+            slot = s;
+    }
+    if (slot != NULL)
+        slot->state = CAPTURE_ENCODING;
+    UnlockBurst(b);
+    if (slot == NULL)
+        return false;
+
+    EncodeCaptureSlot(b, slot);
+
+    // No slot is marked last when the last frame was dropped, the file is complete once no frame is left
+    unsigned int finished = 0;
+    BurstFormat format = BURST_FORMAT_RAW;
+    LockBurst(b);
+    slot->state = CAPTURE_FREE;
+    if (b->unfinishedBurst != 0)
+    {
+        bool pending = false;
+        for (int i = 0; i < BURST_SLOTS; i++)
+            pending |= b->slots[i].state != CAPTURE_FREE && b->slots[i].burst == b->unfinishedBurst;
+        if (!pending)
+        {
+            finished = b->unfinishedBurst;
+            format = b->unfinishedFormat;
+            b->unfinishedBurst = 0;
+        }
+    }
+    UnlockBurst(b);
+    if (finished != 0)
+        FinishBurstFile(b, finished, format);
+    return true;
+}
+
+// Write the next frame of the oldest finished PNG burst, false if no burst waits to be converted
+static bool ConvertNextBurstFrame(BurstCapture *b)
+{
+    if (b->numConversions == 0)
+        return false;
+    char rawName[64];
+    snprintf(rawName, sizeof(rawName), "burst_%04u.rgb", b->conversions[0]);
+    if (b->convertFile == NULL)
+    {
+        b->convertFile = fopen(rawName, "rb");
+        b->convertFrame = 0;
+    }
+    size_t frameSize = (size_t)b->width * b->height * 3;
+    if (b->convertFile != NULL && fread(b->convertPixels, 1, frameSize, b->convertFile) == frameSize)
+    {
+        char fileName[64];
+        snprintf(fileName, sizeof(fileName), "burst_%04u_%02u.png", b->conversions[0], b->convertFrame++);
+        ExportImage((Image){b->convertPixels, b->width, b->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8}, fileName);
+        QueueBurstSave(b, fileName);
+        return true;
+    }
+
+    // Every frame is written, the raw file is not needed anymore
+    if (b->convertFile != NULL)
+    {
+        fclose(b->convertFile);
+        b->convertFile = NULL;
+        remove(rawName);
+    }
+    b->numConversions--;
+    memmove(&b->conversions[0], &b->conversions[1], b->numConversions * sizeof(b->conversions[0]));
+    return true;
+}
+
+#if defined(BURST_THREADED)
+static void *BurstWorker(void *arg)
+{
+    BurstCapture *b = (BurstCapture *)arg;
+    MemCategoryPush(MEM_IMAGES);
+    pthread_mutex_lock(&b->lock);
+    while (b->running)
+    {
+        bool anyFilled = false;
+        for (int i = 0; i < BURST_SLOTS; i++)
+            anyFilled |= b->slots[i].state == CAPTURE_FILLED;
+        if (!anyFilled && b->numConversions == 0)
+        {
+            pthread_cond_wait(&b->slotFilled, &b->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&b->lock);
+        // Captures first, a conversion only runs while no slot waits
+        if (!EncodeNextCapture(b))
+            ConvertNextBurstFrame(b);
+        pthread_mutex_lock(&b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+    MemCategoryPop();
+    return NULL;
+}
+#endif
+
+static void StopBurstWorker(BurstCapture *b)
+{
+    if (!b->running)
+        return;
+#if defined(BURST_THREADED)
+    pthread_mutex_lock(&b->lock);
+    b->running = false;
+    pthread_cond_signal(&b->slotFilled);
+    pthread_mutex_unlock(&b->lock);
+    pthread_join(b->thread, NULL);
+#endif
+    // Finish whatever is left before the slots go away
+    while (EncodeNextCapture(b) || ConvertNextBurstFrame(b))
+        ;
+    b->running = false;
+#if defined(BURST_THREADED)
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->slotFilled);
+#endif
+}
+
+// Allocate the ring for frames of the given size, done before a burst so capturing never allocates
+static void AllocBurstSlots(BurstCapture *b, int width, int height)
+{
+    if (b->running && b->width == width && b->height == height)
+        return;
+    StopBurstWorker(b);
+    MemCategoryPush(MEM_IMAGES);
+    for (int i = 0; i < BURST_SLOTS; i++)
+    {
+        MemFree(b->slots[i].pixels);
+        b->slots[i] = (CaptureSlot){(unsigned char *)MemAlloc(width * height * 4), CAPTURE_FREE};
+    }
+    MemFree(b->convertPixels);
+    b->convertPixels = (unsigned char *)MemAlloc(width * height * 3);
+    MemCategoryPop();
+    b->width = width;
+    b->height = height;
+    b->running = true;
+#if defined(BURST_THREADED)
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->slotFilled, NULL);
+    pthread_create(&b->thread, NULL, BurstWorker, b);
+#endif
+}
+
+void StartBurst(int numFrames)
+{
+    BurstCapture *b = &burstCapture;
+    if (b->remaining > 0) // Already capturing
+        return;
+    b->format = DEFAULT_BURST_FORMAT;
+    int width, height; // As shown, a quarter turn swaps them
+    if (IsFrameSourceActive())
+        GetOrientedFrameSize(frameSource.width, frameSource.height, &width, &height);
+    else if (testImage.data != NULL) // The still decoded at startup, shared with the textures and the pipeline
+        GetOrientedFrameSize(testImage.width, testImage.height, &width, &height);
+    else
+        return;
+    AllocBurstSlots(b, width, height);
+    b->burst++;
+    b->frame = 0;
+    b->dropped = 0;
+    b->remaining = numFrames;
+    b->timeAccumulator = 1.0f / BURST_FPS; // Capture the first still frame right away
+}
+
+// Copy one frame into the ring as it is shown, called by the frame source before it recycles the frame's buffer
+void CaptureBurstFrame(const unsigned char *rgba, int width, int height)
+{
+    BurstCapture *b = &burstCapture;
+    if (b->remaining == 0)
+        return;
+
+    // A tool switched during the burst may turn the frame, it no longer fits the slots and is dropped
+    int orientedWidth, orientedHeight;
+    GetOrientedFrameSize(width, height, &orientedWidth, &orientedHeight);
+    CaptureSlot *slot = NULL;
+    b->remaining--;
+    LockBurst(b);
+    for (int i = 0; i < BURST_SLOTS && slot == NULL && orientedWidth == b->width && orientedHeight == b->height; i++)
+    {
+        if (b->slots[i].state == CAPTURE_FREE)
+            slot = &b->slots[i];
+    }
+    if (slot == NULL)
+    {
+        // The encoder finishes a burst that already has frames once they are written
+        b->dropped++;
+        if (b->remaining == 0 && b->frame > 0)
+        {
+            b->unfinishedBurst = b->burst;
+            b->unfinishedFormat = b->format;
+        }
+    }
+    UnlockBurst(b);
+    if (b->remaining == 0 && b->dropped > 0)
+        TraceLog(LOG_WARNING, "BURST: %u of %u frames dropped, encoding could not keep up", b->dropped, b->frame + b->dropped);
+    if (slot == NULL)
+        return;
+
+    OrientFrame(rgba, width, height, slot->pixels);
+    b->capturedThisTick = true;
+    LockBurst(b);
+    slot->burst = b->burst;
+    slot->frame = b->frame++;
+    slot->last = b->remaining == 0;
+    slot->format = b->format;
+    slot->state = CAPTURE_FILLED;
+#if defined(BURST_THREADED)
+    pthread_cond_signal(&b->slotFilled);
+#endif
+    UnlockBurst(b);
+}
+
+bool IsBurstCapturing(void)
+{
+    return burstCapture.remaining > 0;
+}
+
+// Call once per frame, captures still backgrounds at BURST_FPS and hands finished files to the browser
+void UpdateBurstCapture(float deltaTime)
+{
+    BurstCapture *b = &burstCapture;
+    if (b->remaining > 0 && !IsFrameSourceActive() && testImage.data != NULL)
+    {
+        b->timeAccumulator += deltaTime;
+        if (b->timeAccumulator >= 1.0f / BURST_FPS)
+        {
+            b->timeAccumulator = 0;
+            CaptureBurstFrame((const unsigned char *)testImage.data, testImage.width, testImage.height);
+        }
+    }
+#if !defined(BURST_THREADED)
+    // Encode on ticks without a capture, so a tick never pays for both and the small ring keeps draining
+    if (!b->capturedThisTick && !EncodeNextCapture(b))
+        ConvertNextBurstFrame(b);
+    b->capturedThisTick = false;
+#endif
+#if defined(PLATFORM_WEB)
+    LockBurst(b);
+    for (int i = 0; i < b->numPendingSaves; i++)
+        emscripten_run_script(TextFormat("saveFileFromMEMFSToDisk('%s','%s')", b->pendingSaves[i], b->pendingSaves[i]));
+    b->numPendingSaves = 0;
+    UnlockBurst(b);
+#endif
+}
+
+void UnloadBurstCapture(void)
+{
+    BurstCapture *b = &burstCapture;
+    StopBurstWorker(b);
+    for (int i = 0; i < BURST_SLOTS; i++)
+        MemFree(b->slots[i].pixels);
+    MemFree(b->convertPixels);
+    *b = (BurstCapture){0};
+}
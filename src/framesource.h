@@ -0,0 +1,483 @@
+// Streaming frame source for the background image
+// Frames come from a synthetic pattern, an 8 bit 4:2:0 Y4M file, a raw RGB file or a numbered PNG sequence and are
+// shown at a steady rate. A worker thread decodes into a ring of FRAME_SLOTS preallocated RGBA buffers and the
+// render thread uploads the next ready one into whichever of two streaming textures is not on screen, so it
+// never waits on decoding. Web builds without pthreads decode at most one frame per tick on the main thread.
+//
+// Source specs: "synthetic", "synthetic:WxH", "clip.y4m", "clip.rgb:WxH", "frames/frame_%04d.png"
+
+#if !defined(PLATFORM_WEB) || defined(__EMSCRIPTEN_PTHREADS__)
+#define FRAME_SOURCE_THREADED
+#include <pthread.h>
+#endif
+
+#define FRAME_SLOTS 3
+#define DEFAULT_FRAME_SOURCE_FPS 30.0f
+
+typedef enum FrameSourceType
+{
+    FRAME_SOURCE_NONE = 0,
+    FRAME_SOURCE_SYNTHETIC,
+    FRAME_SOURCE_Y4M,
+    FRAME_SOURCE_RAW_RGB,
+    FRAME_SOURCE_PNG_SEQUENCE
+} FrameSourceType;
+
+typedef enum FrameSlotState
+{
+    SLOT_FREE = 0,
+    SLOT_DECODING,
+    SLOT_READY
+} FrameSlotState;
+
+typedef struct FrameSlot
+{
+    unsigned char *pixels; // RGBA8, width * height * 4
+    FrameSlotState state;
+    unsigned int index; // Frame number, shown in increasing order
+} FrameSlot;
+
+typedef struct FrameSource
+{
+    FrameSourceType type;
+    char path[256];
+    int width;
+    int height;
+    float frameTime; // Seconds between shown frames
+    FILE *file;
+    long dataStart;     // Offset of the first frame, for looping
+    unsigned char *yuv; // Y4M planes of one frame
+    bool fullRange;     // Y4M samples use 0-255 instead of the usual 16-235
+    int sequenceStart;  // First number of a PNG sequence
+    int sequenceNumber; // Next number of a PNG sequence to decode
+    unsigned int nextDecodeIndex;
+    FrameSlot slots[FRAME_SLOTS];
+    TextureHandle textures[2];
+    int currentTexture;
+    float timeAccumulator;
+    unsigned int framesShown;
+    unsigned int lateTicks; // Ticks where no decoded frame was ready
+    bool running;
+#if defined(FRAME_SOURCE_THREADED)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t slotFreed;
+#endif
+} FrameSource;
+
+static FrameSource frameSource = {0};
+
+static void LockFrameSource(FrameSource *s)
+{
+#if defined(FRAME_SOURCE_THREADED)
+    pthread_mutex_lock(&s->lock);
+#endif
+}
+
+static void UnlockFrameSource(FrameSource *s)
+{
+#if defined(FRAME_SOURCE_THREADED)
+    pthread_mutex_unlock(&s->lock);
+#endif
+}
+
+static unsigned char ClampByte(int value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// Color bars with a square bouncing across them
+static void GenSyntheticFrame(FrameSource *s, unsigned int index, unsigned char *rgba)
+{
+    static const Color bars[8] = {{255, 255, 255, 255}, {255, 255, 0, 255}, {0, 255, 255, 255}, {0, 255, 0, 255},
+                                  {255, 0, 255, 255}, {255, 0, 0, 255}, {0, 0, 255, 255}, {0, 0, 0, 255}};
+    int size = s->height / 6;
+    int travel = s->width - size;
+    int boxX = travel > 0 ? (int)(index * 4) % (2 * travel) : 0; // A frame narrower than the box keeps it still
+    if (boxX > travel)
+        boxX = 2 * travel - boxX;
+    int boxY = (s->height - size) / 2;
+    for (int y = 0; y < s->height; y++)
+    {
+        for (int x = 0; x < s->width; x++)
+        {
+            Color c = bars[x * 8 / s->width];
+            bool inBox = x >= boxX && x < boxX + size && y >= boxY && y < boxY + size;
+            unsigned char *p = &rgba[(y * s->width + x) * 4];
+            p[0] = inBox ? 255 - c.r : c.r;
+            p[1] = inBox ? 255 - c.g : c.g;
+            p[2] = inBox ? 255 - c.b : c.b;
+            p[3] = 255;
+        }
+    }
+}
+
+// Read one 4:2:0 frame and convert it with the BT.601 matrix, loops at the end of the file
+static bool DecodeY4MFrame(FrameSource *s, unsigned char *rgba)
+{
+    int lumaSize = s->width * s->height;
+    int chromaWidth = (s->width + 1) / 2;
+    int chromaSize = chromaWidth * ((s->height + 1) / 2);
+    char line[128];
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        if (fgets(line, sizeof(line), s->file) != NULL && strncmp(line, "FRAME", 5) == 0 &&
+            fread(s->yuv, 1, lumaSize + 2 * chromaSize, s->file) == (size_t)(lumaSize + 2 * chromaSize))
+        {
+            const unsigned char *yPlane = s->yuv;
+            const unsigned char *uPlane = s->yuv + lumaSize;
+            const unsigned char *vPlane = uPlane + chromaSize;
+            for (int y = 0; y < s->height; y++)
+            {
+                for (int x = 0; x < s->width; x++)
+                {
+                    int luma = yPlane[y * s->width + x];
+                    int u = uPlane[(y / 2) * chromaWidth + x / 2] - 128;
+                    int v = vPlane[(y / 2) * chromaWidth + x / 2] - 128;
+                    unsigned char *p = &rgba[(y * s->width + x) * 4];
+                    if (s->fullRange)
+                    {
+                        p[0] = ClampByte(luma + ((359 * v) >> 8));
+                        p[1] = ClampByte(luma - ((88 * u + 183 * v) >> 8));
+                        p[2] = ClampByte(luma + ((454 * u) >> 8));
+                    }
+                    else // Luma 16-235 and chroma 16-240, stretched to 0-255
+                    {
+                        int c = 298 * (luma - 16) + 128;
+                        p[0] = ClampByte((c + 409 * v) >> 8);
+                        p[1] = ClampByte((c - 100 * u - 208 * v) >> 8);
+                        p[2] = ClampByte((c + 516 * u) >> 8);
+                    }
+                    p[3] = 255;
+                }
+            }
+            return true;
+        }
+        fseek(s->file, s->dataStart, SEEK_SET);
+    }
+    return false;
+}
+
+static bool DecodeRawRGBFrame(FrameSource *s, unsigned char *rgba)
+{
+    int size = s->width * s->height * 3;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        // Read into the back of the slot and expand to RGBA in place, front to back
+        unsigned char *rgb = rgba + s->width * s->height;
+        if (fread(rgb, 1, size, s->file) == (size_t)size)
+        {
+            for (int i = 0; i < s->width * s->height; i++)
+            {
+                rgba[i * 4 + 0] = rgb[i * 3 + 0];
+                rgba[i * 4 + 1] = rgb[i * 3 + 1];
+                rgba[i * 4 + 2] = rgb[i * 3 + 2];
+                rgba[i * 4 + 3] = 255;
+            }
+            return true;
+        }
+        fseek(s->file, 0, SEEK_SET);
+    }
+    return false;
+}
+
+static bool DecodePNGFrame(FrameSource *s, unsigned char *rgba)
+{
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        char path[300];
+        snprintf(path, sizeof(path), s->path, s->sequenceNumber);
+        if (FileExists(path))
+        {
+            MemCategoryPush(MEM_IMAGES);
+            Image image = LoadImage(path);
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            if (image.width != s->width || image.height != s->height)
+                ImageResize(&image, s->width, s->height);
+            memcpy(rgba, image.data, s->width * s->height * 4);
+            UnloadImage(image);
+            MemCategoryPop();
+            s->sequenceNumber++;
+            return true;
+        }
+        s->sequenceNumber = s->sequenceStart; // Loop back to the first frame
+    }
+    return false;
+}
+
+static bool DecodeFrame(FrameSource *s, unsigned int index, unsigned char *rgba)
+{
+    switch (s->type)
+    {
+    case FRAME_SOURCE_SYNTHETIC:
+        GenSyntheticFrame(s, index, rgba);
+        return true;
+    case FRAME_SOURCE_Y4M:
+        return DecodeY4MFrame(s, rgba);
+    case FRAME_SOURCE_RAW_RGB:
+        return DecodeRawRGBFrame(s, rgba);
+    case FRAME_SOURCE_PNG_SEQUENCE:
+        return DecodePNGFrame(s, rgba);
+    default:
+        return false;
+    }
+}
+
+// Claim a free slot and decode the next frame into it, false if no slot was free or decoding failed
+static bool DecodeIntoFreeSlot(FrameSource *s)
+{
+    FrameSlot *slot = NULL;
+    LockFrameSource(s);
+    for (int i = 0; i < FRAME_SLOTS && slot == NULL; i++)
+    {
+        if (s->slots[i].state == SLOT_FREE)
+            slot = &s->slots[i];
+    }
+    if (slot == NULL)
+    {
+        UnlockFrameSource(s);
+        return false;
+    }
+    slot->state = SLOT_DECODING;
+    unsigned int index = s->nextDecodeIndex++;
+    UnlockFrameSource(s);
+
+    bool decoded = DecodeFrame(s, index, slot->pixels);
+
+    LockFrameSource(s);
+    slot->state = decoded ? SLOT_READY : SLOT_FREE;
+    slot->index = index;
+    UnlockFrameSource(s);
+    return decoded;
+}
+
+#if defined(FRAME_SOURCE_THREADED)
+static void *FrameSourceWorker(void *arg)
+{
+    FrameSource *s = (FrameSource *)arg;
+    pthread_mutex_lock(&s->lock);
+    while (s->running)
+    {
+        bool anyFree = false;
+        for (int i = 0; i < FRAME_SLOTS; i++)
+            anyFree |= s->slots[i].state == SLOT_FREE;
+        if (!anyFree)
+        {
+            pthread_cond_wait(&s->slotFreed, &s->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&s->lock);
+        if (!DecodeIntoFreeSlot(s))
+        {
+            TraceLog(LOG_WARNING, "FRAMES: Could not decode a frame from %s", s->path);
+            pthread_mutex_lock(&s->lock);
+            s->running = false;
+            break;
+        }
+        pthread_mutex_lock(&s->lock);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+#endif
+
+// Parse the stream header and size, returns false if the file is missing or not supported
+static bool OpenY4M(FrameSource *s)
+{
+    s->file = fopen(s->path, "rb");
+    if (s->file == NULL)
+        return false;
+    char header[512];
+    if (fgets(header, sizeof(header), s->file) == NULL || strncmp(header, "YUV4MPEG2", 9) != 0)
+        return false;
+    for (char *token = strtok(header + 9, " \n"); token != NULL; token = strtok(NULL, " \n"))
+    {
+        if (token[0] == 'W')
+            s->width = atoi(token + 1);
+        else if (token[0] == 'H')
+            s->height = atoi(token + 1);
+        else if (token[0] == 'C' && (strncmp(token, "C420", 4) != 0 || (token[4] == 'p' && token[5] >= '0' && token[5] <= '9')))
+        {
+            // C420jpeg, C420mpeg2 and C420paldv only differ in chroma siting, C420p10 and up are not 8 bit
+            TraceLog(LOG_WARNING, "FRAMES: Only 8 bit 4:2:0 Y4M files are supported, %s is %s", s->path, token);
+            return false;
+        }
+        else if (strcmp(token, "XCOLORRANGE=FULL") == 0)
+            s->fullRange = true;
+    }
+    if (s->width <= 0 || s->height <= 0)
+        return false;
+    s->dataStart = ftell(s->file);
+    s->yuv = (unsigned char *)MemAlloc(s->width * s->height + 2 * ((s->width + 1) / 2) * ((s->height + 1) / 2));
+    return s->yuv != NULL;
+}
+
+static bool OpenPNGSequence(FrameSource *s)
+{
+    // Sequences may be numbered from 0 or 1
+    for (s->sequenceStart = 0; s->sequenceStart <= 1; s->sequenceStart++)
+    {
+        char path[300];
+        snprintf(path, sizeof(path), s->path, s->sequenceStart);
+        if (!FileExists(path))
+            continue;
+        Image first = LoadImage(path);
+        s->width = first.width;
+        s->height = first.height;
+        UnloadImage(first);
+        s->sequenceNumber = s->sequenceStart;
+        return s->width > 0 && s->height > 0; // 0 when the first frame could not be decoded
+    }
+    return false;
+}
+
+void CloseFrameSource(void)
+{
+    FrameSource *s = &frameSource;
+    if (s->slots[0].pixels != NULL)
+    {
+#if defined(FRAME_SOURCE_THREADED)
+        pthread_mutex_lock(&s->lock);
+        s->running = false;
+        pthread_cond_signal(&s->slotFreed);
+        pthread_mutex_unlock(&s->lock);
+        pthread_join(s->thread, NULL);
+        pthread_mutex_destroy(&s->lock);
+        pthread_cond_destroy(&s->slotFreed);
+#endif
+        for (int i = 0; i < FRAME_SLOTS; i++)
+            MemFree(s->slots[i].pixels);
+        UnloadManagedTexture(s->textures[0]);
+        UnloadManagedTexture(s->textures[1]);
+    }
+    if (s->file != NULL)
+        fclose(s->file);
+    MemFree(s->yuv);
+    *s = (FrameSource){0};
+}
+
+bool OpenFrameSource(const char *spec, float fps)
+{
+    FrameSource *s = &frameSource;
+    *s = (FrameSource){0};
+    s->frameTime = 1.0f / fps;
+    s->width = screenWidth;
+    s->height = screenHeight;
+
+    const char *size = strrchr(spec, ':');
+    int length = size != NULL ? (int)(size - spec) : (int)strlen(spec);
+    snprintf(s->path, sizeof(s->path), "%.*s", length, spec);
+    if (size != NULL && (sscanf(size + 1, "%dx%d", &s->width, &s->height) != 2 || s->width <= 0 || s->height <= 0))
+    {
+        TraceLog(LOG_WARNING, "FRAMES: Invalid frame size in %s", spec);
+        return false;
+    }
+
+    bool opened = false;
+    if (strcmp(s->path, "synthetic") == 0)
+    {
+        s->type = FRAME_SOURCE_SYNTHETIC;
+        opened = true;
+    }
+    else if (strchr(s->path, '%') != NULL)
+    {
+        s->type = FRAME_SOURCE_PNG_SEQUENCE;
+        opened = OpenPNGSequence(s);
+    }
+    else if (strcmp(GetFileExtension(s->path), ".y4m") == 0)
+    {
+        s->type = FRAME_SOURCE_Y4M;
+        opened = OpenY4M(s);
+    }
+    else if (size != NULL)
+    {
+        s->type = FRAME_SOURCE_RAW_RGB;
+        s->file = fopen(s->path, "rb");
+        opened = s->file != NULL;
+    }
+    if (!opened)
+    {
+        TraceLog(LOG_WARNING, "FRAMES: Could not open frame source %s", spec);
+        CloseFrameSource();
+        return false;
+    }
+
+    s->textures[0] = LoadStreamingTexture(s->width, s->height);
+    s->textures[1] = LoadStreamingTexture(s->width, s->height);
+    if (s->textures[0] < 0 || s->textures[1] < 0) // Refused by the texture budget
+    {
+        UnloadManagedTexture(s->textures[0]);
+        UnloadManagedTexture(s->textures[1]);
+        CloseFrameSource();
+        return false;
+    }
+    MemCategoryPush(MEM_IMAGES);
+    for (int i = 0; i < FRAME_SLOTS; i++)
+        s->slots[i].pixels = (unsigned char *)MemAlloc(s->width * s->height * 4);
+    MemCategoryPop();
+    s->running = true;
+#if defined(FRAME_SOURCE_THREADED)
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->slotFreed, NULL);
+    pthread_create(&s->thread, NULL, FrameSourceWorker, s);
+#endif
+    TraceLog(LOG_INFO, "FRAMES: Streaming %s at %dx%d, %.1f fps", s->path, s->width, s->height, fps);
+    return true;
+}
+
+bool IsFrameSourceActive(void)
+{
+    return frameSource.type != FRAME_SOURCE_NONE && frameSource.slots[0].pixels != NULL;
+}
+
+// Call once per frame from the render thread, shows the next decoded frame when it is due
+void UpdateFrameSource(float deltaTime)
+{
+    FrameSource *s = &frameSource;
+    if (!IsFrameSourceActive())
+        return;
+#if !defined(FRAME_SOURCE_THREADED)
+    DecodeIntoFreeSlot(s);
+#endif
+
+    s->timeAccumulator += deltaTime;
+    if (s->timeAccumulator < s->frameTime)
+        return;
+    s->timeAccumulator -= s->frameTime;
+    if (s->timeAccumulator > s->frameTime) // Don't try to catch up after a stall
+        s->timeAccumulator = 0;
+
+    FrameSlot *next = NULL;
+    LockFrameSource(s);
+    for (int i = 0; i < FRAME_SLOTS; i++)
+    {
+        if (s->slots[i].state == SLOT_READY && (next == NULL || s->slots[i].index < next->index))
+            next = &s->slots[i];
+    }
+    UnlockFrameSource(s);
+    if (next == NULL)
+    {
+        s->lateTicks++;
+        return;
+    }
+
+    // Upload into the texture that is not on screen, then swap
+    int back = 1 - s->currentTexture;
+    UpdateManagedTexture(s->textures[back], next->pixels);
+    s->currentTexture = back;
+    s->framesShown++;
+    CaptureBurstFrame(next->pixels, s->width, s->height);
+    ProcessPipelineFrame(next->pixels, s->width, s->height);
+
+    LockFrameSource(s);
+    next->state = SLOT_FREE;
+#if defined(FRAME_SOURCE_THREADED)
+    pthread_cond_signal(&s->slotFreed);
+#endif
+    UnlockFrameSource(s);
+}
+
+void DrawFrameSource(Rectangle dest, Color tint)
+{
+    DrawManagedTexture(frameSource.textures[frameSource.currentTexture], dest, tint);
+}
@@ -3,11 +3,25 @@ void UpdateGame(void);      // Update game (one frame)
 void DrawGame(void);        // Draw game (one frame)
 void UnloadGame(void);      // Unload game
 void UpdateDrawFrame(void); // Update and Draw (one frame)
+bool InitHudFontStep(void);
+bool InitWheelShaderStep(void);
+bool InitFrameSourceStep(void);
+bool InitTestTextureStep(void);
+bool InitGrayscaleTextureStep(void);
+bool InitAudioStep(void);
+bool InitMusicStep(void);
+Image LoadTestImage(void);
 void DrawHeader(void);
-void DrawButton(const char *text, int posX, int posY, int button, int fontSize);
+void DrawButton(int label, int posX, int posY, int button); // label is a ButtonLabelSlot
 int ApplyButton(int button);
 void ApplyRightStick(void);
 void DrawWheel(void);
 void DrawWheelSelection(void);
 void IncrementWheelSelection(void);
-void DecrementWheelSelection(void);
\ No newline at end of file
+void DecrementWheelSelection(void);
+void ApplyTool(int tool);
+void DrawBackground(bool dimmed);
+void CaptureBurstFrame(const unsigned char *rgba, int width, int height);
+void ProcessPipelineFrame(const unsigned char *rgba, int width, int height);
+void GetOrientedFrameSize(int width, int height, int *orientedWidth, int *orientedHeight);
+void OrientFrame(const unsigned char *rgba, int width, int height, unsigned char *dst);
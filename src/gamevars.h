@@ -14,10 +14,14 @@ const char *startText = "Press any button on gamepad to begin\n   Click game win
 const int screenWidth = 800;
 const int screenHeight = 600;
 const Vector2 center = {screenWidth / 2, screenHeight / 2};
+const Rectangle screenRect = {0, 0, screenWidth, screenHeight};
 int framesCounter = 0;
-Texture2D testTex;
-Texture2D grayscaleTestTex;
+Image testImage;          // fire.png decoded once as RGBA8, source of testTex
+Image grayscaleTestImage; // Source of grayscaleTestTex
+TextureHandle testTex = -1; // Invalid until startup loads it, 0 is a valid slot
+TextureHandle grayscaleTestTex = -1;
 Music music;
+const char *frameSourceSpec = NULL; // --source <spec>, opened during startup
 
 // Wheel header
 static const char *headerOptions[NUM_HEADER_OPTIONS] = {"Camera", "Processing", "Tools"};
@@ -96,6 +100,7 @@ Color wheelOptionColors[NUM_HEADER_OPTIONS][NUM_WHEEL_OPTIONS][NUM_WHEEL_OPTIONS
         {WHITE, WHITE, WHITE, WHITE, WHITE, WHITE, WHITE, WHITE},
     }};
 int selectedWheelOptions[NUM_HEADER_OPTIONS][NUM_WHEEL_OPTIONS] = {{0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0}};
+bool segmentEnabled[NUM_HEADER_OPTIONS][NUM_WHEEL_OPTIONS] = {0}; // Processing tools switched on with LB, see pipeline.h
 
 // Tools
 char toolStrings[256][12] = {
@@ -0,0 +1,65 @@
+// Undo history
+// Applying a processing tool first pushes the state it replaces: the segment it switches with its icon colors and
+// the PipelineKey() of the frame the tools produced. Options picked with LT and RT are not part of it. No pixels are
+// kept, every frame follows from the key and the still or streamed source, so undo recomputes it from the proxy
+// level up like a closing wheel does. The oldest states are evicted past MAX_HISTORY_STATES.
+
+#define MAX_HISTORY_STATES 64
+
+typedef struct HistoryState
+{
+    int header, segment; // Of the switched segment
+    bool enabled;        // Before it was switched
+    Color colors[NUM_WHEEL_OPTIONS];
+    unsigned int key; // PipelineKey() of the frame before it was switched
+} HistoryState;
+
+typedef struct History
+{
+    HistoryState states[MAX_HISTORY_STATES]; // Oldest first
+    int numStates;
+} History;
+
+static History history = {0};
+
+// Remember a segment and the tools switched on in the wheel, call before switching the segment
+void PushHistoryState(int header, int segment)
+{
+    History *h = &history;
+    if (h->numStates == MAX_HISTORY_STATES)
+    {
+        memmove(&h->states[0], &h->states[1], (MAX_HISTORY_STATES - 1) * sizeof(HistoryState));
+        h->numStates--;
+    }
+    HistoryState *state = &h->states[h->numStates++];
+    state->header = header;
+    state->segment = segment;
+    state->enabled = segmentEnabled[header][segment];
+    memcpy(state->colors, wheelOptionColors[header][segment], sizeof(state->colors));
+    state->key = PipelineKey(false);
+}
+
+int GetHistoryDepth(void)
+{
+    return history.numStates;
+}
+
+// Switch the segment of the last applied tool back and recompute the frame from before it, false when there is
+// nothing to undo
+bool UndoHistoryState(void)
+{
+    History *h = &history;
+    if (h->numStates == 0)
+        return false;
+    HistoryState *state = &h->states[--h->numStates];
+    segmentEnabled[state->header][state->segment] = state->enabled;
+    memcpy(wheelOptionColors[state->header][state->segment], state->colors, sizeof(state->colors));
+    RestartPipeline(state->key);
+    *state = (HistoryState){0};
+    return true;
+}
+
+void UnloadHistory(void)
+{
+    history = (History){0};
+}
@@ -0,0 +1,102 @@
+// HUD layout, every anchor the wheel and header draw at is computed here once and only read per frame
+
+#define NUM_TOOL_STRINGS 256
+#define HEADER_FONT_SIZE 20
+#define TOOL_NAME_FONT_SIZE 24
+#define HINT_FONT_SIZE 20
+#define BUTTON_PRESSED_GROWTH 4 // Font size added to a button label while its button is pressed
+
+static const char *moveHintText = " Move RS to\nselect a tool";
+static const char *applyHintText = "Release LB to\n  apply tool";
+
+typedef struct ButtonLabel
+{
+    const char *text;
+    int fontSize;
+} ButtonLabel;
+
+// One slot per DrawButton() call site, so its label width is a plain table read
+typedef enum ButtonLabelSlot
+{
+    BUTTON_LABEL_LB,
+    BUTTON_LABEL_B,
+    BUTTON_LABEL_RB,
+    BUTTON_LABEL_LT,
+    BUTTON_LABEL_RT,
+    NUM_BUTTON_LABELS
+} ButtonLabelSlot;
+
+static const ButtonLabel buttonLabels[NUM_BUTTON_LABELS] = {
+    [BUTTON_LABEL_LB] = {"LB", 20},
+    [BUTTON_LABEL_B] = {"B", 20},
+    [BUTTON_LABEL_RB] = {"RB", 16},
+    [BUTTON_LABEL_LT] = {"LT", 10},
+    [BUTTON_LABEL_RT] = {"RT", 10},
+};
+
+typedef struct SegmentAnchors
+{
+    Vector2 icon;      // Top left of the segment icon
+    Vector2 ltButton;  // LT button beside the segment
+    Vector2 rtButton;  // RT button beside the segment
+} SegmentAnchors;
+
+typedef struct HudLayout
+{
+    bool valid;
+    SegmentAnchors segments[NUM_WHEEL_OPTIONS];
+    Vector2 toolNames[NUM_TOOL_STRINGS]; // Origin of each tool name, indexed by icon id
+    Vector2 moveHint;
+    Vector2 applyHint;
+    int headerOptions[NUM_HEADER_OPTIONS]; // x of each header option
+    int headerOptionsY;
+    int buttonWidths[NUM_BUTTON_LABELS][2]; // Of each label slot, released and pressed
+} HudLayout;
+
+static HudLayout hudLayout = {0};
+
+// Call when the wheel configuration or the header options change
+void InvalidateLayout(void)
+{
+    hudLayout.valid = false;
+}
+
+// Recompute the anchors if they were invalidated. They derive from the fixed screenWidth x screenHeight window,
+// so only a change of font or wheel configuration moves them.
+void UpdateLayout(void)
+{
+    if (hudLayout.valid)
+        return;
+
+    for (int i = 0; i < NUM_WHEEL_OPTIONS; i++)
+    {
+        SegmentAnchors *s = &hudLayout.segments[i];
+        s->icon = (Vector2){segmentCenters[i].x - 24, segmentCenters[i].y - 24};
+        TriggerButtonAnchors(wheelCenter, wheelRadius, segmentCenters[i], startAngles[i], endAngles[i], &s->ltButton, &s->rtButton);
+    }
+
+    for (int i = 0; i < NUM_TOOL_STRINGS; i++)
+        hudLayout.toolNames[i] = (Vector2){wheelCenter.x - MeasureHudText(toolStrings[i], TOOL_NAME_FONT_SIZE) / 2, wheelCenter.y - 88};
+    hudLayout.moveHint = (Vector2){wheelCenter.x - MeasureHudText(moveHintText, HINT_FONT_SIZE) / 2, wheelCenter.y + 60};
+    hudLayout.applyHint = (Vector2){wheelCenter.x - MeasureHudText(applyHintText, HINT_FONT_SIZE) / 2, wheelCenter.y + 60};
+
+    // Center all the header options together
+    int totalWidth = 0;
+    for (int i = 0; i < NUM_HEADER_OPTIONS; i++)
+        totalWidth += MeasureHudText(headerOptions[i], HEADER_FONT_SIZE) + 10;
+    int txtPos = (int)((int)center.x - totalWidth / 2.0);
+    for (int i = 0; i < NUM_HEADER_OPTIONS; i++)
+    {
+        hudLayout.headerOptions[i] = txtPos;
+        txtPos += MeasureHudText(headerOptions[i], HEADER_FONT_SIZE) + 10;
+    }
+    hudLayout.headerOptionsY = 67;
+
+    for (int i = 0; i < NUM_BUTTON_LABELS; i++)
+    {
+        hudLayout.buttonWidths[i][0] = MeasureHudText(buttonLabels[i].text, buttonLabels[i].fontSize);
+        hudLayout.buttonWidths[i][1] = MeasureHudText(buttonLabels[i].text, buttonLabels[i].fontSize + BUTTON_PRESSED_GROWTH);
+    }
+
+    hudLayout.valid = true;
+}
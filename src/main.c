@@ -1,25 +1,59 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <raylib.h>
 
+#if defined(PLATFORM_WEB)
+#include <emscripten/emscripten.h>
+#ifndef WEB_TARGET_FPS
+#define WEB_TARGET_FPS 0 // 0 lets the browser drive the main loop with requestAnimationFrame
+#endif
+#endif
+
+#include "./memtrack.h"
+#include "./textures.h"
 #include "./gamevars.h"
 #include "./functions.h"
+#include "./wheelmath.h"
+#include "./sdftext.h"
+#include "./wheelshader.h"
+#include "./layout.h"
+#include "./framesource.h"
+#include "./burst.h"
+#include "./pipeline.h"
+#include "./history.h"
+#include "./startup.h"
 
-#if defined(PLATFORM_WEB)
-#include <emscripten/emscripten.h>
+#if defined(RENDER_SNAPSHOTS)
+#include "./snapshots.h"
 #endif
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT);
-    InitWindow(screenWidth, screenHeight, "RDR2 Wheel");
+#if defined(RENDER_SNAPSHOTS)
+    SetConfigFlags((SHADER_WHEEL ? 0 : FLAG_MSAA_4X_HINT) | FLAG_WINDOW_HIDDEN);
+    InitWindow(screenWidth, screenHeight, "RDR2 Wheel snapshots");
     InitGame();
-    InitAudioDevice();
-    music = LoadMusicStream("resources/sounds/western.mp3");
+    UpdateStartup(true);
+    int failures = RunSnapshots(argc > 1 && strcmp(argv[1], "--update") == 0);
+    UnloadGame();
+    CloseWindow();
+    return failures > 0 ? 1 : 0;
+#endif
+
+    SetConfigFlags((SHADER_WHEEL ? 0 : FLAG_MSAA_4X_HINT) | FLAG_VSYNC_HINT); // The shader wheel anti-aliases itself
+    MemCategoryPush(MEM_UI);
+    InitWindow(screenWidth, screenHeight, "RDR2 Wheel");
+    MemCategoryPop();
+    BeginStartup();
+    // Stream the background from a frame source instead of the test image: --source <spec>, see framesource.h
+    if (argc > 2 && strcmp(argv[1], "--source") == 0)
+        frameSourceSpec = argv[2];
+    InitGame(); // The rest is loaded by the startup steps, see startup.h
 
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    emscripten_set_main_loop(UpdateDrawFrame, WEB_TARGET_FPS, 1);
 #else
     SetTargetFPS(60);
     while (!WindowShouldClose()) // Detect window close button or ESC key
@@ -38,29 +72,98 @@ void InitGame(void)
 
     // Init some wheel parameters
     segmentAngleSpan = 360.0 / NUM_WHEEL_OPTIONS;
-    halfUsedAngleSpan = (segmentAngleSpan - 2.0) / 2.0;
-    for (int i = 0; i < NUM_WHEEL_OPTIONS; i++)
-    {
-        startAngles[i] = i * segmentAngleSpan - halfUsedAngleSpan;
-        endAngles[i] = i * segmentAngleSpan + halfUsedAngleSpan;
-        float midAngle = (1 / 360.0) * PI * (startAngles[i] + endAngles[i] - 180.0);
-        segmentCenters[i] = (Vector2){wheelCenter.x + cos(midAngle) * wheelRadius * 0.8,
-                                      wheelCenter.y - sin(midAngle) * wheelRadius * 0.8};
-    }
+    halfUsedAngleSpan = ComputeSegmentAngles(NUM_WHEEL_OPTIONS, wheelCenter, wheelRadius, startAngles, endAngles, segmentCenters);
+}
 
-    // Generate the test textures
-    Image testImage = LoadImage("resources/images/fire.png");
-    Image testGrayscaleImage = ImageCopy(testImage);
-    ImageColorGrayscale(&testGrayscaleImage);
-    ImageResize(&testImage, screenWidth, screenHeight);
-    testTex = LoadTextureFromImage(testImage);
-    grayscaleTestTex = LoadTextureFromImage(testGrayscaleImage);
-    UnloadImage(testImage);
+bool InitHudFontStep(void)
+{
+    MemCategoryPush(MEM_FONTS);
+    bool loaded = LoadHudFontStep();
+    MemCategoryPop();
+    if (!loaded)
+        return false;
+    MemCategoryPush(MEM_UI);
+    InvalidateLayout(); // Text anchors were measured with the default font until now
+    UpdateLayout();
+    MemCategoryPop();
+    return true;
+}
+
+bool InitWheelShaderStep(void)
+{
+#if SHADER_WHEEL
+    LoadWheelShader();
+#endif
+    return true;
+}
+
+bool InitFrameSourceStep(void)
+{
+    if (frameSourceSpec != NULL)
+        OpenFrameSource(frameSourceSpec, DEFAULT_FRAME_SOURCE_FPS);
+    return true;
+}
+
+bool InitTestTextureStep(void)
+{
+    MemCategoryPush(MEM_IMAGES);
+    testImage = LoadTestImage();
+    MemCategoryPop();
+    testTex = LoadManagedTexture(&testImage, false);
+    return true;
+}
+
+bool InitGrayscaleTextureStep(void)
+{
+    MemCategoryPush(MEM_IMAGES);
+    grayscaleTestImage = ImageCopy(testImage);
+    ImageColorGrayscale(&grayscaleTestImage);
+    MemCategoryPop();
+    grayscaleTestTex = LoadManagedTexture(&grayscaleTestImage, true);
+    return true;
+}
+
+bool InitAudioStep(void)
+{
+    MemCategoryPush(MEM_AUDIO);
+    InitAudioDevice();
+    MemCategoryPop();
+    return true;
+}
+
+bool InitMusicStep(void)
+{
+    MemCategoryPush(MEM_AUDIO);
+    music = LoadMusicStream("resources/sounds/western.mp3");
+    MemCategoryPop();
+    return true;
+}
+
+Image LoadTestImage(void)
+{
+    Image image = LoadImage("resources/images/fire.png");
+    ImageResize(&image, screenWidth, screenHeight);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return image;
 }
 
 void UpdateGame(void)
 {
     framesCounter++;
+    UpdateStartup(IsGamepadAvailable(0)); // Everything is needed once a gamepad is there
+    UpdateLayout();
+    if (IsGamepadAvailable(0) && IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1))
+    {
+        wheelSelection = NULL_VAL;
+        UseTexture(grayscaleTestTex); // Restore the wheel's background before drawing starts, if it was dropped
+    }
+    // Before the pipeline runs, so the frame that closes the wheel already shows the tool
+    if (IsGamepadAvailable(0) && IsGamepadButtonReleased(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1) && wheelSelection != NULL_VAL)
+        ApplyTool(wheelOptions[headerSelection][wheelSelection][selectedWheelOptions[headerSelection][wheelSelection]]);
+    UpdatePipeline();
+    UpdateFrameSource(GetFrameTime());
+    UpdateBurstCapture(GetFrameTime());
+    UpdateTextureResidency();
 }
 
 void DrawGame(void)
@@ -70,18 +173,17 @@ void DrawGame(void)
 
     if (IsGamepadAvailable(0))
     {
+        MemCategoryPush(MEM_AUDIO);
         SetMusicVolume(music, 1.0 - selectedWheelOptions[2][0] / 2.0);
         if (!IsMusicStreamPlaying(music))
             PlayMusicStream(music);
         else
             UpdateMusicStream(music);
-
-        if (IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1))
-            wheelSelection = NULL_VAL;
+        MemCategoryPop();
 
         if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1))
         {
-            DrawTexture(grayscaleTestTex, 0, 0, WHITE);
+            DrawBackground(true);
             DrawHeader();
             ApplyRightStick();
             DrawWheel();
@@ -89,24 +191,55 @@ void DrawGame(void)
         }
         else
         {
-            DrawTexture(testTex, 0, 0, WHITE);
-            DrawButton("LB", 50, screenHeight - 50, GAMEPAD_BUTTON_LEFT_TRIGGER_1, 20);
-            DrawText("To open wheel", 75, screenHeight - 50, 20, WHITE);
+            DrawBackground(false);
+            DrawButton(BUTTON_LABEL_LB, 50, screenHeight - 50, GAMEPAD_BUTTON_LEFT_TRIGGER_1);
+            DrawHudText("To open wheel", 75, screenHeight - 50, 20, WHITE);
+            if (GetHistoryDepth() > 0)
+            {
+                DrawButton(BUTTON_LABEL_B, 50, screenHeight - 90, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT);
+                DrawHudText("To undo", 75, screenHeight - 90, 20, WHITE);
+            }
+            if (IsBurstCapturing())
+                DrawHudText("Capturing", screenWidth - 120, 20, 20, RED);
             if (headerSelection == 2 && wheelSelection == 1) // TESTING
-                DrawText("You can do it!", center.x - MeasureText("You can do it!", 70) / 2, center.y - 35, 70, GREEN);
+                DrawHudText("You can do it!", center.x - MeasureHudText("You can do it!", 70) / 2, center.y - 35, 70, GREEN);
         }
     }
     else
     {
-        DrawText(startText, center.x - MeasureText(startText, 20) / 2, center.y - 20, 20, GRAY);
+        DrawHudText(startText, center.x - MeasureHudText(startText, 20) / 2, center.y - 20, 20, GRAY);
     }
 
+    FlushHudText();
+    DrawMemOverlay();
     EndDrawing();
 }
 
+// Test image, streamed frame or processed frame, dimmed while the wheel is open
+void DrawBackground(bool dimmed)
+{
+    if (IsPipelineOriented())
+        DrawPipelineFrame(screenRect, dimmed ? GRAY : WHITE);
+    else if (IsFrameSourceActive())
+        DrawFrameSource(screenRect, dimmed ? GRAY : WHITE);
+    else
+        DrawManagedTexture(dimmed ? grayscaleTestTex : testTex, screenRect, WHITE);
+    DrawPipelineOverlay(screenRect);
+}
+
 void UnloadGame(void)
 {
-    UnloadTexture(testTex);
+    UnloadBurstCapture();
+    UnloadHistory();
+    UnloadPipeline();
+    CloseFrameSource();
+    UnloadManagedTextures();
+    UnloadImage(testImage);
+    UnloadImage(grayscaleTestImage);
+    UnloadHudFont();
+#if SHADER_WHEEL
+    UnloadWheelShader();
+#endif
     UnloadMusicStream(music);
     CloseAudioDevice();
 }
@@ -115,39 +248,30 @@ void UpdateDrawFrame(void)
 {
     UpdateGame();
     DrawGame();
+    EndStartupFrame();
 }
 
 void DrawHeader(void)
 {
     DrawRectangleRounded(wheelHeader, 0.2, 10, Fade(BLACK, 0.8f));
-    DrawButton("RB", (int)center.x, 38, GAMEPAD_BUTTON_RIGHT_TRIGGER_1, 16);
-
-    // Determine the width of all the header options together
-    int fontSize = 20;
-    int totalWidth = 0;
-    for (int i = 0; i < NUM_HEADER_OPTIONS; i++)
-    {
-        totalWidth += MeasureText(headerOptions[i], fontSize) + 10;
-    }
+    DrawButton(BUTTON_LABEL_RB, (int)center.x, 38, GAMEPAD_BUTTON_RIGHT_TRIGGER_1);
 
     // Draw the header options
-    int txtPos = (int)((int)center.x - totalWidth / 2.0);
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < NUM_HEADER_OPTIONS; i++)
     {
         Color c = headerSelection == i ? WHITE : Fade(WHITE, 0.3f);
-        DrawText(headerOptions[i], txtPos, 67, fontSize, c);
-        txtPos += (int)MeasureText(headerOptions[i], fontSize) + 10;
+        DrawHudText(headerOptions[i], hudLayout.headerOptions[i], hudLayout.headerOptionsY, HEADER_FONT_SIZE, c);
     }
 }
 
-void DrawButton(const char *text, int posX, int posY, int button, int fontSize)
+void DrawButton(int label, int posX, int posY, int button)
 {
-    if (ApplyButton(button) == 1)
-        fontSize += 4;
-    int txtWid = MeasureText(text, fontSize);
+    bool pressed = ApplyButton(button) == 1;
+    int txtWid = hudLayout.buttonWidths[label][pressed];
+    int fontSize = buttonLabels[label].fontSize + (pressed ? BUTTON_PRESSED_GROWTH : 0);
     int txtPos = posX - txtWid / 2;
     DrawRectangleRounded((Rectangle){txtPos - 5, posY - 5, txtWid + 10, fontSize + 10}, 0.2, 10, WHITE);
-    DrawText(text, txtPos, posY, fontSize, BLACK);
+    DrawHudText(buttonLabels[label].text, txtPos, posY, fontSize, BLACK);
 }
 
 int ApplyButton(int button)
@@ -169,6 +293,9 @@ int ApplyButton(int button)
             DecrementWheelSelection();
             framesCounter = 0;
             break;
+        case GAMEPAD_BUTTON_RIGHT_FACE_RIGHT:
+            UndoHistoryState();
+            break;
         default:
             break;
         }
@@ -178,95 +305,94 @@ int ApplyButton(int button)
 
 void ApplyRightStick(void)
 {
-    // Determine if the rightStickWheel vector is greater than the ring radius * 0.99
     Vector2 rightStick = (Vector2){GetGamepadAxisMovement(0, GAMEPAD_AXIS_RIGHT_X), GetGamepadAxisMovement(0, GAMEPAD_AXIS_RIGHT_Y)};
-    Vector2 rightStickWheel = (Vector2){wheelCenter.x + rightStick.x * wheelRadius, wheelCenter.y + rightStick.y * wheelRadius};
-    float rightStickWheelMag = sqrt(pow(rightStickWheel.x - wheelCenter.x, 2) + pow(rightStickWheel.y - wheelCenter.y, 2));
-
-    if (rightStickWheelMag > wheelRadius * 0.99) // User is selecting a segment
+    int segment = StickToSegment(rightStick, NUM_WHEEL_OPTIONS, startAngles, endAngles, halfUsedAngleSpan);
+    if (segment != -1) // User is selecting a segment
     {
-        float angle = atan2(rightStick.y, rightStick.x) * 180 / PI - 90;
-        if (angle < 0)
-            angle += 360;
-        angle = abs((int)(360 - angle));
-
-        for (int i = 0; i < NUM_WHEEL_OPTIONS; i++)
-        {
-            // Determine if the angle points towards the ring segement being drawn and
-            // solve edge case crossing quadrant 4 -> quadrant 3
-            if ((angle >= startAngles[i] && angle <= endAngles[i]) ||
-                (i == 0 && angle > 360.0 - halfUsedAngleSpan && angle <= 360.0))
-            {
-                wheelSelection = i;
-                framesCounter = 0;
-            }
-        }
+        wheelSelection = segment;
+        framesCounter = 0;
     }
 }
 
 void DrawWheel(void)
 {
-    DrawCircleV(wheelCenter, wheelRadius * 0.57, Fade(BLACK, 0.5f)); // Draw the background
+#if SHADER_WHEEL
+    // Background, segments and selection arc in one pass
+    bool selected = wheelSelection != NULL_VAL && wheelOptions[headerSelection][wheelSelection][0] != ICON_NONE;
+    DrawWheelShader(wheelCenter, wheelRadius, NUM_WHEEL_OPTIONS, selected ? wheelSelection : -1);
+#else
+    DrawCircleV(wheelCenter, wheelRadius * WHEEL_DISC_RADIUS, Fade(BLACK, 0.5f)); // Draw the background
+#endif
     DrawLineV((Vector2){wheelCenter.x - 90, wheelCenter.y - 50}, (Vector2){wheelCenter.x + 90, wheelCenter.y - 50}, WHITE);
     DrawLineV((Vector2){wheelCenter.x - 90, wheelCenter.y + 50}, (Vector2){wheelCenter.x + 90, wheelCenter.y + 50}, WHITE);
     for (int i = 0; i < NUM_WHEEL_OPTIONS; i++) // Draw the segments
     {
-        DrawRing(wheelCenter, wheelRadius * 0.6, wheelRadius, startAngles[i], endAngles[i], 100, Fade(BLACK, 0.8f));
+#if !SHADER_WHEEL
+        DrawRing(wheelCenter, wheelRadius * WHEEL_INNER_RADIUS, wheelRadius, startAngles[i], endAngles[i], 100, Fade(BLACK, 0.8f));
+#endif
         GuiDrawIcon(wheelOptions[headerSelection][i][selectedWheelOptions[headerSelection][i]],
-                    segmentCenters[i].x - 24, segmentCenters[i].y - 24, 3,
+                    hudLayout.segments[i].icon.x, hudLayout.segments[i].icon.y, 3,
                     wheelOptionColors[headerSelection][i][selectedWheelOptions[headerSelection][i]]);
     }
+#if !defined(RENDER_SNAPSHOTS) // Snapshots pin the selection, GetFPS() stays 0 without EndDrawing()
     if (wheelSelection != NULL_VAL) // Determine if the user is not doing anything
     {
         framesCounter++;
         if (framesCounter > GetFPS() * 1.5)
             wheelSelection = NULL_VAL;
     }
+#endif
 }
 
 void DrawWheelSelection(void)
 {
     if (wheelSelection == NULL_VAL || wheelOptions[headerSelection][wheelSelection][0] == ICON_NONE)
     {
-        DrawText(" Move RS to\nselect a tool", wheelCenter.x - MeasureText(" Move RS to\nselect a tool", 20) / 2, wheelCenter.y + 60, 20, WHITE);
+        DrawHudText(moveHintText, hudLayout.moveHint.x, hudLayout.moveHint.y, HINT_FONT_SIZE, WHITE);
         return;
     }
     // Write the name and description of the selected tool
-    char *thisToolString = toolStrings[wheelOptions[headerSelection][wheelSelection][selectedWheelOptions[headerSelection][wheelSelection]]];
-    DrawText(thisToolString, wheelCenter.x - MeasureText(thisToolString, 24) / 2, wheelCenter.y - 88, 24, WHITE);
-    DrawText("Release LB to\n  apply tool", wheelCenter.x - MeasureText("Release LB to\n  apply tool", 20) / 2, wheelCenter.y + 60, 20, WHITE);
-
-    float startAngle = startAngles[wheelSelection];
-    float endAngle = endAngles[wheelSelection];
-    Vector2 center = segmentCenters[wheelSelection];
-    DrawRing(wheelCenter, wheelRadius * 0.95, wheelRadius, startAngle, endAngle, 100, Fade(MAROON, 0.8f));
+    unsigned char thisTool = wheelOptions[headerSelection][wheelSelection][selectedWheelOptions[headerSelection][wheelSelection]];
+    DrawHudText(toolStrings[thisTool], hudLayout.toolNames[thisTool].x, hudLayout.toolNames[thisTool].y, TOOL_NAME_FONT_SIZE, WHITE);
+    DrawHudText(applyHintText, hudLayout.applyHint.x, hudLayout.applyHint.y, HINT_FONT_SIZE, WHITE);
+
+#if !SHADER_WHEEL // The shader wheel draws the selection arc itself
+    DrawRing(wheelCenter, wheelRadius * WHEEL_SELECTION_RADIUS, wheelRadius, startAngles[wheelSelection], endAngles[wheelSelection], 100, Fade(MAROON, 0.8f));
+#endif
     // Not a scrollable option, so don't activate trigger buttons
     if (wheelOptions[headerSelection][wheelSelection][1] == ICON_NONE)
         return;
-    // Find the intersection of the line in the logical place for the LT/RT buttons
-    float buttonProjection = -pow(center.y, 2) + 2 * center.y * wheelCenter.y - pow(wheelCenter.y, 2);
-    int buttonInner = sqrt(buttonProjection + pow(wheelRadius * 0.625, 2));
-    int buttonOuter = sqrt(buttonProjection + pow(wheelRadius, 2));
-    // Finally place the buttons depending on the angle of the segment
-    if (isnan(buttonInner) || abs(buttonInner) > NULL_VAL)
-    {
-        double r = wheelRadius * 0.8;
-        float RTangle = (startAngle >= 0 && startAngle <= 180) ? startAngle : endAngle;
-        float LTangle = (startAngle >= 0 && startAngle <= 180) ? endAngle : startAngle;
-        DrawButton("LT", (int)(r * cos((RTangle + 90.0) * PI / 180.0) + wheelCenter.x),
-                   (int)(r * sin((RTangle + 90.0) * PI / 180.0) + wheelCenter.y), GAMEPAD_BUTTON_LEFT_TRIGGER_2, 10);
-        DrawButton("RT", (int)(r * cos((LTangle + 90.0) * PI / 180.0) + wheelCenter.x),
-                   (int)(r * sin((LTangle + 90.0) * PI / 180.0) + wheelCenter.y), GAMEPAD_BUTTON_RIGHT_TRIGGER_2, 10);
-    }
-    else if (center.x > wheelCenter.x)
-    {
-        DrawButton("LT", (int)(wheelCenter.x + buttonInner), (int)center.y, GAMEPAD_BUTTON_LEFT_TRIGGER_2, 10);
-        DrawButton("RT", (int)(wheelCenter.x + buttonOuter), (int)center.y, GAMEPAD_BUTTON_RIGHT_TRIGGER_2, 10);
-    }
-    else
+    SegmentAnchors *anchors = &hudLayout.segments[wheelSelection];
+    DrawButton(BUTTON_LABEL_LT, (int)anchors->ltButton.x, (int)anchors->ltButton.y, GAMEPAD_BUTTON_LEFT_TRIGGER_2);
+    DrawButton(BUTTON_LABEL_RT, (int)anchors->rtButton.x, (int)anchors->rtButton.y, GAMEPAD_BUTTON_RIGHT_TRIGGER_2);
+}
+
+void ApplyTool(int tool)
+{
+    switch (tool)
     {
-        DrawButton("LT", (int)(wheelCenter.x - buttonOuter), (int)center.y, GAMEPAD_BUTTON_LEFT_TRIGGER_2, 10);
-        DrawButton("RT", (int)(wheelCenter.x - buttonInner), (int)center.y, GAMEPAD_BUTTON_RIGHT_TRIGGER_2, 10);
+    case ICON_SINGLE:
+        StartBurst(1);
+        break;
+    case ICON_BURST:
+        StartBurst(BURST_FRAMES);
+        break;
+    case ICON_FLIPX:
+    case ICON_FLIPY:
+    case ICON_ROT90:
+    case ICON_ROT180:
+    case ICON_ROT270:
+    case ICON_BLOB:
+    case ICON_BLOBTRACK:
+    case ICON_FOCUS:
+        // Switch the segment in or out of the processing pipeline, its icons turn green while it is on
+        PushHistoryState(headerSelection, wheelSelection);
+        segmentEnabled[headerSelection][wheelSelection] = !segmentEnabled[headerSelection][wheelSelection];
+        for (int i = 0; i < NUM_WHEEL_OPTIONS; i++)
+            wheelOptionColors[headerSelection][wheelSelection][i] = segmentEnabled[headerSelection][wheelSelection] ? GREEN : WHITE;
+        break;
+    default:
+        break;
     }
 }
 
@@ -0,0 +1,218 @@
+// Heap usage tracking by category
+// Build with -DMEMTRACK and link with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+// (buildWASM.py --memtrack does both) so raylib's own allocations are counted too.
+// Allocations are charged to the category on top of the stack pushed with MemCategoryPush() on the same thread.
+
+typedef enum MemCategory
+{
+    MEM_SCRATCH = 0, // Anything allocated outside a pushed category
+    MEM_IMAGES,
+    MEM_AUDIO,
+    MEM_FONTS,
+    MEM_UI,
+    NUM_MEM_CATEGORIES
+} MemCategory;
+
+typedef struct MemStats
+{
+    size_t current[NUM_MEM_CATEGORIES];
+    size_t peak[NUM_MEM_CATEGORIES];
+    size_t totalCurrent;
+    size_t totalPeak;
+    size_t highWater; // Highest linear memory address the heap reached (web only, 0 on native)
+    int untracked;    // Allocations that did not fit in the pointer table
+} MemStats;
+
+#if defined(MEMTRACK)
+#include <stdint.h>
+#include <unistd.h>
+
+#define MEM_TABLE_SIZE 65536 // Live allocations tracked at once, must be a power of 2
+#define MEM_STACK_DEPTH 16
+
+typedef struct MemEntry
+{
+    void *ptr;
+    size_t size;
+    unsigned char category;
+} MemEntry;
+
+static const char *memCategoryNames[NUM_MEM_CATEGORIES] = {"Scratch", "Images", "Audio", "Fonts", "UI"};
+static MemStats memStats = {0};
+static MemEntry memTable[MEM_TABLE_SIZE];
+static __thread unsigned char memCategoryStack[MEM_STACK_DEPTH];
+static __thread int memCategoryDepth = 0;
+static volatile char memLock = 0; // Spin lock, worker threads allocate too
+
+static void MemLock(void)
+{
+    while (__atomic_test_and_set(&memLock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+static void MemUnlock(void)
+{
+    __atomic_clear(&memLock, __ATOMIC_RELEASE);
+}
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static size_t MemSlot(void *ptr)
+{
+    uintptr_t h = (uintptr_t)ptr >> 3;
+    h ^= h >> 16;
+    return (size_t)(h * 0x45d9f3b) & (MEM_TABLE_SIZE - 1);
+}
+
+static MemCategory CurrentMemCategory(void)
+{
+    // Pushes past MEM_STACK_DEPTH are not stored, they keep charging the deepest stored category
+    int depth = memCategoryDepth < MEM_STACK_DEPTH ? memCategoryDepth : MEM_STACK_DEPTH;
+    return depth > 0 ? (MemCategory)memCategoryStack[depth - 1] : MEM_SCRATCH;
+}
+
+static void TrackAlloc(void *ptr, size_t size, MemCategory category)
+{
+    if (ptr == NULL)
+        return;
+    size_t slot = MemSlot(ptr);
+    for (int probes = 0; memTable[slot].ptr != NULL; probes++)
+    {
+        if (probes == MEM_TABLE_SIZE)
+        {
+            memStats.untracked++;
+            return;
+        }
+        slot = (slot + 1) & (MEM_TABLE_SIZE - 1);
+    }
+    memTable[slot] = (MemEntry){ptr, size, category};
+
+    memStats.current[category] += size;
+    if (memStats.current[category] > memStats.peak[category])
+        memStats.peak[category] = memStats.current[category];
+    memStats.totalCurrent += size;
+    if (memStats.totalCurrent > memStats.totalPeak)
+        memStats.totalPeak = memStats.totalCurrent;
+#if defined(PLATFORM_WEB)
+    size_t top = (size_t)sbrk(0);
+    if (top > memStats.highWater)
+        memStats.highWater = top;
+#endif
+}
+
+// Pointers allocated before tracking started or outside C (emscripten's JS side) are not in the table and are ignored.
+// Returns the removed entry, its ptr is NULL when there was none.
+static MemEntry UntrackAlloc(void *ptr)
+{
+    if (ptr == NULL)
+        return (MemEntry){0};
+    size_t slot = MemSlot(ptr);
+    for (int probes = 0; memTable[slot].ptr != ptr; probes++)
+    {
+        if (memTable[slot].ptr == NULL || probes == MEM_TABLE_SIZE)
+            return (MemEntry){0};
+        slot = (slot + 1) & (MEM_TABLE_SIZE - 1);
+    }
+    MemEntry entry = memTable[slot];
+    memStats.current[memTable[slot].category] -= memTable[slot].size;
+    memStats.totalCurrent -= memTable[slot].size;
+
+    // Shift the following entries of the probe chain back so lookups never hit a hole
+    size_t hole = slot;
+    size_t next = (slot + 1) & (MEM_TABLE_SIZE - 1);
+    while (memTable[next].ptr != NULL)
+    {
+        size_t home = MemSlot(memTable[next].ptr);
+        if (((next - home) & (MEM_TABLE_SIZE - 1)) >= ((next - hole) & (MEM_TABLE_SIZE - 1)))
+        {
+            memTable[hole] = memTable[next];
+            hole = next;
+        }
+        next = (next + 1) & (MEM_TABLE_SIZE - 1);
+    }
+    memTable[hole].ptr = NULL;
+    return entry;
+}
+
+void *__wrap_malloc(size_t size)
+{
+    void *ptr = __real_malloc(size);
+    MemLock();
+    TrackAlloc(ptr, size, CurrentMemCategory());
+    MemUnlock();
+    return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    void *ptr = __real_calloc(count, size);
+    MemLock();
+    TrackAlloc(ptr, count * size, CurrentMemCategory());
+    MemUnlock();
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    // Held across the call like in __wrap_free, once the old block is freed its address can be handed out again
+    MemLock();
+    MemEntry old = UntrackAlloc(ptr);
+    void *newPtr = __real_realloc(ptr, size);
+    if (newPtr == NULL && size > 0) // The old block is still alive
+        TrackAlloc(old.ptr, old.size, (MemCategory)old.category);
+    else
+        TrackAlloc(newPtr, size, CurrentMemCategory());
+    MemUnlock();
+    return newPtr;
+}
+
+void __wrap_free(void *ptr)
+{
+    // Untrack first, once freed the address can be handed out again by another thread
+    MemLock();
+    UntrackAlloc(ptr);
+    MemUnlock();
+    __real_free(ptr);
+}
+
+void MemCategoryPush(MemCategory category)
+{
+    if (memCategoryDepth < MEM_STACK_DEPTH)
+        memCategoryStack[memCategoryDepth] = category;
+    memCategoryDepth++;
+}
+
+void MemCategoryPop(void)
+{
+    if (memCategoryDepth > 0)
+        memCategoryDepth--;
+}
+
+MemStats GetMemStats(void)
+{
+    return memStats;
+}
+
+// Exported for measureWASM.js and buildWASM.py --heap auto
+size_t GetMemPeak(void) { return memStats.totalPeak; }
+size_t GetMemHighWater(void) { return memStats.highWater; }
+
+// Current and peak bytes of every category in the top left corner
+void DrawMemOverlay(void)
+{
+    DrawRectangle(5, 5, 230, 14 * (NUM_MEM_CATEGORIES + 1) + 10, Fade(BLACK, 0.6f));
+    for (int i = 0; i < NUM_MEM_CATEGORIES; i++)
+        DrawText(TextFormat("%-8s %8.1f KB  peak %8.1f KB", memCategoryNames[i], memStats.current[i] / 1024.0, memStats.peak[i] / 1024.0),
+                 10, 10 + 14 * i, 10, WHITE);
+    DrawText(TextFormat("%-8s %8.1f KB  peak %8.1f KB", "Total", memStats.totalCurrent / 1024.0, memStats.totalPeak / 1024.0),
+             10, 10 + 14 * NUM_MEM_CATEGORIES, 10, YELLOW);
+}
+#else
+void MemCategoryPush(MemCategory category) {}
+void MemCategoryPop(void) {}
+MemStats GetMemStats(void) { return (MemStats){0}; }
+void DrawMemOverlay(void) {}
+#endif
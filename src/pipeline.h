@@ -0,0 +1,780 @@
+// Processing pipeline
+// Chains the tools switched on with LB (Flip X/Y, Rotate, Blob Detect/Track, Focus Value) into an ordered list of
+// stages, rebuilt only when a tool is switched or its selected option changes. Per-pixel stages run back to back on
+// one band of rows while it is in cache, so the frame is read once whatever the number of tools. Intermediate
+// buffers come from a small pool that is reused from frame to frame instead of being allocated per stage.
+// While the wheel is open the stages, including the tool under the stick, run on a cached 1/4 scale proxy of the
+// frame so scrolling through tools previews instantly. After LB is released the result refines one level per frame
+// back to full resolution.
+
+#define PIPELINE_TILE_ROWS 16 // Rows per tile, a tile of the 800 px wide frame stays well inside L2
+#define PIPELINE_POOL_SIZE 8
+#define MAX_PIPELINE_STAGES 8
+#define BLOB_THRESHOLD 200        // Luma a pixel needs to be part of a blob
+#define BLOB_MIN_AREA 64          // Pixels
+#define MAX_BLOB_RUNS 32768       // Runs of blob pixels per frame, detection gives up on noisier frames
+#define MAX_BLOBS 32
+#define BLOB_TRACK_DISTANCE 40.0f // Full resolution pixels a tracked blob may move between two frames
+#define PROXY_LEVEL 2             // Halvings of the frame processed while the wheel is open
+
+// Maps an output pixel to its source pixel: sx = xx * x + xy * y + x0, sy = yx * x + yy * y + y0
+typedef struct PixelMap
+{
+    int xx, xy, x0;
+    int yx, yy, y0;
+} PixelMap;
+
+typedef struct PipelineBuffer
+{
+    void *data;
+    size_t capacity;
+    bool inUse;
+} PipelineBuffer;
+
+typedef struct PipelineTile
+{
+    int y; // First row
+    int rows;
+    unsigned char *rgba; // Rows of the oriented frame
+    unsigned char *luma; // The same rows as 8-bit luma
+} PipelineTile;
+
+typedef struct Pipeline Pipeline;
+
+typedef struct PipelineStage
+{
+    const char *name;
+    bool (*begin)(Pipeline *p);                 // Before the first tile, may be NULL, false skips the stage this frame
+    void (*tile)(Pipeline *p, PipelineTile *t); // Per-pixel work on one tile, NULL for stages that only use results
+    void (*end)(Pipeline *p);                   // After the last tile, may be NULL
+    bool readsLuma;                             // Skipped when no luma buffer could be acquired
+} PipelineStage;
+
+typedef struct BlobRun
+{
+    int y, x0, x1; // x1 inclusive
+    int parent;    // Union-find link to another run of the same blob
+} BlobRun;
+
+typedef struct BlobAccumulator
+{
+    int minX, minY, maxX, maxY;
+    int area;
+    float sumX, sumY;
+} BlobAccumulator;
+
+typedef struct ProxyFrame
+{
+    unsigned char *pixels; // RGBA8
+    int width, height;
+    size_t capacity;
+} ProxyFrame;
+
+typedef struct Blob
+{
+    Rectangle bounds; // In oriented frame pixels
+    Vector2 centroid;
+    int area;
+    int id;        // Track id, 0 when not tracking
+    char label[8]; // Drawn next to the blob, kept here so it outlives the HUD text queue
+} Blob;
+
+struct Pipeline
+{
+    unsigned int key; // Tools and options the stages were built from
+    bool dirty;       // Not processed since the stages or the level changed
+    const PipelineStage *stages[MAX_PIPELINE_STAGES];
+    int numStages;
+    bool flipX, flipY;
+    int quarterTurns; // Clockwise
+    bool needsLuma;
+
+    const unsigned char *src; // RGBA8 frame being processed
+    int srcWidth, srcHeight;
+    PixelMap map;
+    int width, height; // Of the oriented frame
+    int level;         // Halvings of the frame being processed, 0 is full resolution
+    int shownLevel;    // Level of the oriented frame on screen
+    ProxyFrame proxies[PROXY_LEVEL + 1]; // Downscaled copies of the current frame, index 0 is unused
+    bool proxiesValid;
+    TextureHandle textures[PROXY_LEVEL + 1]; // Oriented frame of each level, loaded when its width is set
+    int textureWidths[PROXY_LEVEL + 1];
+    int textureHeights[PROXY_LEVEL + 1];
+    PipelineBuffer pool[PIPELINE_POOL_SIZE];
+
+    BlobRun *runs;
+    int numRuns;
+    int prevRowRuns; // Index of the first run of the previous row
+    int rowRuns;     // Index of the first run of the current row
+    bool runsOverflow;
+    BlobAccumulator *accumulators;
+    Blob blobs[MAX_BLOBS];
+    int numBlobs;
+    Blob tracked[MAX_BLOBS];
+    int numTracked;
+    int nextTrackId;
+
+    unsigned char *prevLuma; // Last luma row of the previous tile
+    double focusSum;
+    int focusCount;
+    float focusValue;
+    char focusText[24];
+};
+
+static Pipeline pipeline = {0, true};
+
+static void *AcquirePipelineBuffer(Pipeline *p, size_t size)
+{
+    // Smallest free buffer that fits, otherwise grow the largest free one
+    PipelineBuffer *fit = NULL;
+    PipelineBuffer *largest = NULL;
+    for (int i = 0; i < PIPELINE_POOL_SIZE; i++)
+    {
+        PipelineBuffer *b = &p->pool[i];
+        if (b->inUse)
+            continue;
+        if (b->capacity >= size && (fit == NULL || b->capacity < fit->capacity))
+            fit = b;
+        if (largest == NULL || b->capacity > largest->capacity)
+            largest = b;
+    }
+    if (fit == NULL)
+    {
+        if (largest == NULL)
+        {
+            TraceLog(LOG_WARNING, "PIPELINE: Buffer pool exhausted, raise PIPELINE_POOL_SIZE");
+            return NULL;
+        }
+        fit = largest;
+        MemCategoryPush(MEM_IMAGES);
+        MemFree(fit->data);
+        fit->data = MemAlloc(size);
+        MemCategoryPop();
+        fit->capacity = fit->data != NULL ? size : 0;
+        if (fit->data == NULL)
+        {
+            TraceLog(LOG_WARNING, "PIPELINE: Could not allocate a %zu byte buffer", size);
+            return NULL;
+        }
+    }
+    fit->inUse = true;
+    return fit->data;
+}
+
+static void ReleasePipelineBuffer(Pipeline *p, void *data)
+{
+    for (int i = 0; i < PIPELINE_POOL_SIZE; i++)
+    {
+        if (p->pool[i].data == data)
+            p->pool[i].inUse = false;
+    }
+}
+
+// outer(inner(pixel))
+static PixelMap ComposePixelMaps(PixelMap outer, PixelMap inner)
+{
+    return (PixelMap){outer.xx * inner.xx + outer.xy * inner.yx, outer.xx * inner.xy + outer.xy * inner.yy, outer.xx * inner.x0 + outer.xy * inner.y0 + outer.x0,
+                      outer.yx * inner.xx + outer.yy * inner.yx, outer.yx * inner.xy + outer.yy * inner.yy, outer.yx * inner.x0 + outer.yy * inner.y0 + outer.y0};
+}
+
+// Fold the flips and the rotation into one output-to-source map, so orienting costs one gather whatever is switched on
+static PixelMap OrientationMap(bool flipX, bool flipY, int quarterTurns, int w, int h, int *outWidth, int *outHeight)
+{
+    PixelMap map = {1, 0, 0, 0, 1, 0};
+    if (flipX)
+        map = ComposePixelMaps(map, (PixelMap){-1, 0, w - 1, 0, 1, 0});
+    if (flipY)
+        map = ComposePixelMaps(map, (PixelMap){1, 0, 0, 0, -1, h - 1});
+    switch (quarterTurns)
+    {
+    case 1: // Output is h x w
+        map = ComposePixelMaps(map, (PixelMap){0, 1, 0, -1, 0, h - 1});
+        break;
+    case 2:
+        map = ComposePixelMaps(map, (PixelMap){-1, 0, w - 1, 0, -1, h - 1});
+        break;
+    case 3:
+        map = ComposePixelMaps(map, (PixelMap){0, -1, w - 1, 1, 0, 0});
+        break;
+    }
+    *outWidth = quarterTurns % 2 ? h : w;
+    *outHeight = quarterTurns % 2 ? w : h;
+    return map;
+}
+
+static void UpdatePixelMap(Pipeline *p)
+{
+    p->map = OrientationMap(p->flipX, p->flipY, p->quarterTurns, p->srcWidth, p->srcHeight, &p->width, &p->height);
+}
+
+// Gather rows [y, y + rows) of a frame oriented by m that is width pixels wide
+static void GatherRows(const unsigned int *src, int srcWidth, PixelMap m, int width, int y, int rows, unsigned int *dst)
+{
+    int step = m.yx * srcWidth + m.xx; // Source offset between two output pixels of a row
+    for (; rows > 0; y++, rows--)
+    {
+        int offset = (m.yy * y + m.y0) * srcWidth + m.xy * y + m.x0;
+        for (int x = 0; x < width; x++, offset += step)
+            *dst++ = src[offset];
+    }
+}
+
+static void OrientTile(Pipeline *p, PipelineTile *t)
+{
+    GatherRows((const unsigned int *)p->src, p->srcWidth, p->map, p->width, t->y, t->rows, (unsigned int *)t->rgba);
+}
+
+static void LumaTile(Pipeline *p, PipelineTile *t)
+{
+    const unsigned char *rgba = t->rgba;
+    for (int i = 0; i < t->rows * p->width; i++, rgba += 4)
+        t->luma[i] = (77 * rgba[0] + 150 * rgba[1] + 29 * rgba[2]) >> 8;
+}
+
+static int FindBlobRoot(BlobRun *runs, int i)
+{
+    while (runs[i].parent != i)
+    {
+        runs[i].parent = runs[runs[i].parent].parent; // Path halving
+        i = runs[i].parent;
+    }
+    return i;
+}
+
+static bool BlobDetectBegin(Pipeline *p)
+{
+    p->runs = (BlobRun *)AcquirePipelineBuffer(p, MAX_BLOB_RUNS * sizeof(BlobRun));
+    if (p->runs == NULL)
+        return false;
+    p->numRuns = 0;
+    p->prevRowRuns = 0;
+    p->rowRuns = 0;
+    p->runsOverflow = false;
+    return true;
+}
+
+// Collect the runs of bright pixels of every row and join them with the overlapping runs of the row above
+static void BlobDetectTile(Pipeline *p, PipelineTile *t)
+{
+    for (int r = 0; r < t->rows && !p->runsOverflow; r++)
+    {
+        const unsigned char *luma = t->luma + r * p->width;
+        p->prevRowRuns = p->rowRuns;
+        p->rowRuns = p->numRuns;
+        int above = p->prevRowRuns;
+        for (int x = 0; x < p->width; x++)
+        {
+            if (luma[x] < BLOB_THRESHOLD)
+                continue;
+            int x0 = x;
+            while (x < p->width && luma[x] >= BLOB_THRESHOLD)
+                x++;
+            if (p->numRuns == MAX_BLOB_RUNS)
+            {
+                p->runsOverflow = true;
+                break;
+            }
+            int run = p->numRuns++;
+            p->runs[run] = (BlobRun){t->y + r, x0, x - 1, run};
+
+            // Runs of both rows are sorted by x, so the runs above only ever need to be walked once
+            while (above < p->rowRuns && p->runs[above].x1 < x0)
+                above++;
+            for (int a = above; a < p->rowRuns && p->runs[a].x0 <= x - 1; a++)
+            {
+                int rootA = FindBlobRoot(p->runs, a);
+                int rootB = FindBlobRoot(p->runs, run);
+                if (rootA < rootB)
+                    p->runs[rootB].parent = rootA;
+                else
+                    p->runs[rootA].parent = rootB;
+            }
+        }
+    }
+}
+
+static void BlobDetectEnd(Pipeline *p)
+{
+    p->numBlobs = 0;
+    if (p->runsOverflow)
+        TraceLog(LOG_DEBUG, "PIPELINE: Too many blob runs, skipping the frame");
+    else if (p->numRuns > 0)
+    {
+        // Every root run collects its blob, the roots are the runs that are their own parent
+        p->accumulators = (BlobAccumulator *)AcquirePipelineBuffer(p, p->numRuns * sizeof(BlobAccumulator));
+        if (p->accumulators == NULL)
+        {
+            ReleasePipelineBuffer(p, p->runs);
+            return;
+        }
+        for (int i = 0; i < p->numRuns; i++)
+        {
+            BlobRun *run = &p->runs[i];
+            int root = FindBlobRoot(p->runs, i);
+            BlobAccumulator *a = &p->accumulators[root];
+            int length = run->x1 - run->x0 + 1;
+            if (root == i)
+                *a = (BlobAccumulator){run->x0, run->y, run->x1, run->y};
+            a->minX = run->x0 < a->minX ? run->x0 : a->minX;
+            a->maxX = run->x1 > a->maxX ? run->x1 : a->maxX;
+            a->maxY = run->y;
+            a->area += length;
+            a->sumX += length * (run->x0 + run->x1) / 2.0f;
+            a->sumY += (float)length * run->y;
+        }
+        for (int i = 0; i < p->numRuns; i++)
+        {
+            BlobAccumulator *a = &p->accumulators[i];
+            if (p->runs[i].parent != i || a->area < BLOB_MIN_AREA >> (2 * p->level))
+                continue;
+            // Keep the largest MAX_BLOBS
+            int slot = p->numBlobs;
+            if (p->numBlobs == MAX_BLOBS)
+            {
+                slot = 0;
+                for (int b = 1; b < MAX_BLOBS; b++)
+                {
+                    if (p->blobs[b].area < p->blobs[slot].area)
+                        slot = b;
+                }
+                if (p->blobs[slot].area >= a->area)
+                    continue;
+            }
+            else
+                p->numBlobs++;
+            p->blobs[slot] = (Blob){(Rectangle){a->minX, a->minY, a->maxX - a->minX + 1, a->maxY - a->minY + 1},
+                                    (Vector2){a->sumX / a->area, a->sumY / a->area}, a->area};
+        }
+        ReleasePipelineBuffer(p, p->accumulators);
+    }
+    ReleasePipelineBuffer(p, p->runs);
+}
+
+// Give every blob the id of the nearest blob of the previous frame, or a new one.
+// Tracked centroids are kept in full resolution pixels so ids survive a change of proxy level.
+static void BlobTrackEnd(Pipeline *p)
+{
+    bool matched[MAX_BLOBS] = {0};
+    float scale = (float)(1 << p->level);
+    for (int i = 0; i < p->numBlobs; i++)
+    {
+        Blob *blob = &p->blobs[i];
+        int nearest = -1;
+        float nearestDistance = BLOB_TRACK_DISTANCE;
+        for (int j = 0; j < p->numTracked; j++)
+        {
+            float dx = blob->centroid.x * scale - p->tracked[j].centroid.x;
+            float dy = blob->centroid.y * scale - p->tracked[j].centroid.y;
+            float distance = sqrtf(dx * dx + dy * dy);
+            if (!matched[j] && distance < nearestDistance)
+            {
+                nearest = j;
+                nearestDistance = distance;
+            }
+        }
+        if (nearest >= 0)
+        {
+            matched[nearest] = true;
+            blob->id = p->tracked[nearest].id;
+        }
+        else
+            blob->id = ++p->nextTrackId;
+        snprintf(blob->label, sizeof(blob->label), "#%d", blob->id);
+    }
+    for (int i = 0; i < p->numBlobs; i++)
+    {
+        p->tracked[i].id = p->blobs[i].id;
+        p->tracked[i].centroid = (Vector2){p->blobs[i].centroid.x * scale, p->blobs[i].centroid.y * scale};
+    }
+    p->numTracked = p->numBlobs;
+}
+
+static bool FocusBegin(Pipeline *p)
+{
+    p->prevLuma = (unsigned char *)AcquirePipelineBuffer(p, p->width);
+    if (p->prevLuma == NULL)
+    {
+        p->focusText[0] = '\0';
+        return false;
+    }
+    p->focusSum = 0;
+    p->focusCount = 0;
+    return true;
+}
+
+// Mean squared luma gradient, higher is sharper
+static void FocusTile(Pipeline *p, PipelineTile *t)
+{
+    for (int r = 0; r < t->rows; r++)
+    {
+        const unsigned char *row = t->luma + r * p->width;
+        const unsigned char *above = r > 0 ? row - p->width : p->prevLuma;
+        if (t->y + r == 0)
+            continue;
+        long sum = 0;
+        for (int x = 1; x < p->width; x++)
+        {
+            int dx = row[x] - row[x - 1];
+            int dy = row[x] - above[x];
+            sum += dx * dx + dy * dy;
+        }
+        p->focusSum += sum;
+        p->focusCount += p->width - 1;
+    }
+    memcpy(p->prevLuma, t->luma + (t->rows - 1) * p->width, p->width);
+}
+
+static void FocusEnd(Pipeline *p)
+{
+    ReleasePipelineBuffer(p, p->prevLuma);
+    p->focusValue = p->focusCount > 0 ? p->focusSum / p->focusCount : 0;
+    if (p->level > 0)
+        snprintf(p->focusText, sizeof(p->focusText), "Focus %.1f (1/%d)", p->focusValue, 1 << p->level);
+    else
+        snprintf(p->focusText, sizeof(p->focusText), "Focus %.1f", p->focusValue);
+}
+
+static const PipelineStage orientStage = {"Orient", NULL, OrientTile, NULL};
+static const PipelineStage lumaStage = {"Luma", NULL, LumaTile, NULL, true};
+static const PipelineStage blobDetectStage = {"Blob Detect", BlobDetectBegin, BlobDetectTile, BlobDetectEnd, true};
+static const PipelineStage focusStage = {"Focus Value", FocusBegin, FocusTile, FocusEnd, true};
+static const PipelineStage blobTrackStage = {"Blob Track", NULL, NULL, BlobTrackEnd}; // Tracks no blobs without detection
+
+// Tools switched on in the wheel, packed so a change is one comparison.
+// With preview set the segment under the stick counts as switched the way releasing LB would switch it.
+static unsigned int PipelineKey(bool preview)
+{
+    unsigned int key = 0;
+    for (int h = 0; h < NUM_HEADER_OPTIONS; h++)
+    {
+        for (int s = 0; s < NUM_WHEEL_OPTIONS; s++)
+        {
+            bool hovered = preview && h == headerSelection && s == wheelSelection;
+            if (segmentEnabled[h][s] == hovered)
+                continue;
+            switch (wheelOptions[h][s][selectedWheelOptions[h][s]])
+            {
+            case ICON_FLIPX:
+                key |= 1 << 0;
+                break;
+            case ICON_FLIPY:
+                key |= 1 << 1;
+                break;
+            case ICON_ROT90:
+                key |= 1 << 2;
+                break;
+            case ICON_ROT180:
+                key |= 2 << 2;
+                break;
+            case ICON_ROT270:
+                key |= 3 << 2;
+                break;
+            case ICON_BLOBTRACK:
+                key |= 1 << 5; // Tracking needs detection
+                // fall through
+            case ICON_BLOB:
+                key |= 1 << 4;
+                break;
+            case ICON_FOCUS:
+                key |= 1 << 6;
+                break;
+            }
+        }
+    }
+    return key;
+}
+
+static void ReleasePipelineTextures(Pipeline *p)
+{
+    for (int i = 0; i <= PROXY_LEVEL; i++)
+    {
+        if (p->textureWidths[i] > 0)
+            UnloadManagedTexture(p->textures[i]);
+        p->textureWidths[i] = 0;
+        p->textureHeights[i] = 0;
+    }
+}
+
+static void BuildPipeline(Pipeline *p, unsigned int key)
+{
+    p->key = key;
+    p->flipX = key & (1 << 0);
+    p->flipY = key & (1 << 1);
+    p->quarterTurns = (key >> 2) & 3;
+    bool detect = key & (1 << 4);
+    bool track = key & (1 << 5);
+    bool focus = key & (1 << 6);
+    p->needsLuma = detect || focus;
+
+    p->numStages = 0;
+    if (p->flipX || p->flipY || p->quarterTurns != 0)
+        p->stages[p->numStages++] = &orientStage;
+    if (p->needsLuma)
+        p->stages[p->numStages++] = &lumaStage;
+    if (detect)
+        p->stages[p->numStages++] = &blobDetectStage;
+    if (focus)
+        p->stages[p->numStages++] = &focusStage;
+    if (track)
+        p->stages[p->numStages++] = &blobTrackStage;
+
+    if (p->numStages == 0 || p->stages[0] != &orientStage) // The background is drawn from testTex or the frame source again
+        ReleasePipelineTextures(p);
+
+    p->numBlobs = 0;
+    if (!track) // Ids carry over while another tool is switched or previewed
+        p->numTracked = 0;
+    p->focusText[0] = '\0';
+    p->srcWidth = 0; // Recompute the pixel map on the next frame
+    p->dirty = true;
+}
+
+bool IsPipelineOriented(void)
+{
+    return pipeline.numStages > 0 && pipeline.stages[0] == &orientStage;
+}
+
+// Average 2x2 blocks of an RGBA8 frame into one pixel, false if dst could not be allocated
+static bool HalveFrame(const unsigned char *src, int width, int height, ProxyFrame *dst)
+{
+    dst->width = width / 2;
+    dst->height = height / 2;
+    size_t size = (size_t)dst->width * dst->height * 4;
+    if (size > dst->capacity)
+    {
+        MemCategoryPush(MEM_IMAGES);
+        MemFree(dst->pixels);
+        dst->pixels = (unsigned char *)MemAlloc(size);
+        MemCategoryPop();
+        dst->capacity = dst->pixels != NULL ? size : 0;
+        if (dst->pixels == NULL)
+            return false;
+    }
+    for (int y = 0; y < dst->height; y++)
+    {
+        const unsigned char *top = src + (size_t)(2 * y) * width * 4;
+        const unsigned char *bottom = top + width * 4;
+        unsigned char *out = dst->pixels + (size_t)y * dst->width * 4;
+        for (int x = 0; x < dst->width * 4; x += 4)
+        {
+            for (int c = 0; c < 4; c++)
+                out[x + c] = (top[2 * x + c] + top[2 * x + 4 + c] + bottom[2 * x + c] + bottom[2 * x + 4 + c] + 2) >> 2;
+        }
+    }
+    return true;
+}
+
+// Run the stages tile by tile over frame, the oriented frame at the current level
+static void RunStages(Pipeline *p, unsigned char *frame)
+{
+    unsigned char *luma = p->needsLuma ? (unsigned char *)AcquirePipelineBuffer(p, PIPELINE_TILE_ROWS * p->width) : NULL;
+    bool active[MAX_PIPELINE_STAGES];
+    p->numBlobs = 0; // Stays empty when detection is skipped
+    for (int i = 0; i < p->numStages; i++)
+    {
+        const PipelineStage *stage = p->stages[i];
+        active[i] = !(stage->readsLuma && luma == NULL) && (stage->begin == NULL || stage->begin(p));
+    }
+    for (int y = 0; y < p->height; y += PIPELINE_TILE_ROWS)
+    {
+        PipelineTile tile = {y, p->height - y < PIPELINE_TILE_ROWS ? p->height - y : PIPELINE_TILE_ROWS, frame + y * p->width * 4, luma};
+        for (int i = 0; i < p->numStages; i++)
+        {
+            if (active[i] && p->stages[i]->tile != NULL)
+                p->stages[i]->tile(p, &tile);
+        }
+    }
+    for (int i = 0; i < p->numStages; i++)
+    {
+        if (active[i] && p->stages[i]->end != NULL)
+            p->stages[i]->end(p);
+    }
+    if (luma != NULL)
+        ReleasePipelineBuffer(p, luma);
+}
+
+// Upload the oriented frame of the current level
+static void ShowOrientedFrame(Pipeline *p, const unsigned char *frame)
+{
+    // One texture per level, so refining never reallocates
+    int level = p->level;
+    if (p->textureWidths[level] != p->width || p->textureHeights[level] != p->height)
+    {
+        if (p->textureWidths[level] > 0)
+            UnloadManagedTexture(p->textures[level]);
+        p->textures[level] = LoadStreamingTexture(p->width, p->height);
+        p->textureWidths[level] = p->width;
+        p->textureHeights[level] = p->height;
+    }
+    UpdateManagedTexture(p->textures[level], frame);
+    p->shownLevel = level;
+}
+
+// Run the stages over one RGBA8 frame at the current level, tile by tile
+static void RunPipeline(Pipeline *p, const unsigned char *rgba, int width, int height)
+{
+    if (p->level > 0)
+    {
+        // Each level is built from the one above it, only once per source frame
+        if (!p->proxiesValid)
+        {
+            p->proxiesValid = HalveFrame(rgba, width, height, &p->proxies[1]);
+            for (int i = 2; i <= PROXY_LEVEL && p->proxiesValid; i++)
+                p->proxiesValid = HalveFrame(p->proxies[i - 1].pixels, p->proxies[i - 1].width, p->proxies[i - 1].height, &p->proxies[i]);
+            if (!p->proxiesValid)
+            {
+                TraceLog(LOG_WARNING, "PIPELINE: Could not allocate the proxy frames, skipping the frame");
+                p->dirty = false;
+                return;
+            }
+        }
+        rgba = p->proxies[p->level].pixels;
+        width = p->proxies[p->level].width;
+        height = p->proxies[p->level].height;
+    }
+    if (width != p->srcWidth || height != p->srcHeight)
+    {
+        p->srcWidth = width;
+        p->srcHeight = height;
+        UpdatePixelMap(p);
+    }
+    p->src = rgba;
+
+    // Every stage reads the oriented frame, without it the whole frame is skipped
+    bool oriented = IsPipelineOriented();
+    unsigned char *frame = oriented ? (unsigned char *)AcquirePipelineBuffer(p, (size_t)p->width * p->height * 4) : (unsigned char *)rgba;
+    if (frame == NULL)
+    {
+        p->dirty = false;
+        return;
+    }
+    RunStages(p, frame);
+
+    if (oriented)
+    {
+        ShowOrientedFrame(p, frame);
+        ReleasePipelineBuffer(p, frame);
+    }
+    p->dirty = false;
+}
+
+// Process a new RGBA8 frame, called by the frame source for every frame it shows
+void ProcessPipelineFrame(const unsigned char *rgba, int width, int height)
+{
+    Pipeline *p = &pipeline;
+    p->proxiesValid = false;
+    if (p->numStages > 0)
+        RunPipeline(p, rgba, width, height);
+}
+
+// Call once per frame, rebuilds the stages when the tools changed, picks the proxy level
+// and processes the still background when needed
+void UpdatePipeline(void)
+{
+    Pipeline *p = &pipeline;
+    bool wheelOpen = IsGamepadAvailable(0) && IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1);
+    unsigned int key = PipelineKey(wheelOpen);
+    if (key != p->key)
+        BuildPipeline(p, key);
+    if (p->numStages == 0)
+        return;
+
+    // Drop to the proxy as soon as the wheel opens, then refine one level per frame once it is closed
+    if (wheelOpen && p->level != PROXY_LEVEL)
+    {
+        p->level = PROXY_LEVEL;
+        p->dirty = true;
+    }
+    else if (!wheelOpen && p->level > 0 && !p->dirty)
+    {
+        p->level--;
+        p->dirty = true;
+    }
+
+    // The still background is testImage, decoded once at startup and shared with the textures and burst capture
+    if (IsFrameSourceActive() || !p->dirty || testImage.data == NULL)
+        return;
+    RunPipeline(p, (const unsigned char *)testImage.data, testImage.width, testImage.height);
+}
+
+// Size of a width x height frame once the tools switched on in the wheel orient it
+void GetOrientedFrameSize(int width, int height, int *orientedWidth, int *orientedHeight)
+{
+    unsigned int key = PipelineKey(false);
+    OrientationMap(key & (1 << 0), key & (1 << 1), (key >> 2) & 3, width, height, orientedWidth, orientedHeight);
+}
+
+// Write an RGBA8 frame into dst as the tools switched on in the wheel show it, at full resolution.
+// dst holds the GetOrientedFrameSize() of the frame.
+void OrientFrame(const unsigned char *rgba, int width, int height, unsigned char *dst)
+{
+    unsigned int key = PipelineKey(false);
+    int orientedWidth, orientedHeight;
+    PixelMap map = OrientationMap(key & (1 << 0), key & (1 << 1), (key >> 2) & 3, width, height, &orientedWidth, &orientedHeight);
+    if ((key & 0xf) == 0)
+        memcpy(dst, rgba, (size_t)width * height * 4);
+    else
+        GatherRows((const unsigned int *)rgba, width, map, orientedWidth, 0, orientedHeight, (unsigned int *)dst);
+}
+
+// Rebuild the stages for key and recompute the frame from the proxy level, refining over the next updates
+void RestartPipeline(unsigned int key)
+{
+    Pipeline *p = &pipeline;
+    BuildPipeline(p, key);
+    p->level = PROXY_LEVEL;
+}
+
+// Where the oriented frame lands in bounds, letterboxed when a rotation changed its aspect
+static Rectangle PipelineFrameRect(Rectangle bounds)
+{
+    Pipeline *p = &pipeline;
+    if (p->width == 0 || p->height == 0)
+        return bounds;
+    // Every level has the same aspect, up to the pixel lost when halving an odd size
+    float scale = fminf(bounds.width / p->width, bounds.height / p->height);
+    float width = p->width * scale;
+    float height = p->height * scale;
+    return (Rectangle){bounds.x + (bounds.width - width) / 2, bounds.y + (bounds.height - height) / 2, width, height};
+}
+
+// Draw the oriented frame, only valid while IsPipelineOriented()
+void DrawPipelineFrame(Rectangle bounds, Color tint)
+{
+    int level = pipeline.shownLevel;
+    if (pipeline.textureWidths[level] > 0)
+        DrawManagedTexture(pipeline.textures[level], PipelineFrameRect(bounds), tint);
+}
+
+// Blob boxes, track ids and the focus value over the frame drawn in bounds
+void DrawPipelineOverlay(Rectangle bounds)
+{
+    Pipeline *p = &pipeline;
+    if (p->numStages == 0)
+        return;
+    // Placed like DrawBackground() places the frame: letterboxed while oriented, otherwise stretched over bounds
+    Rectangle frame = IsPipelineOriented() ? PipelineFrameRect(bounds) : bounds;
+    float scaleX = p->width > 0 ? frame.width / p->width : 1.0f;
+    float scaleY = p->height > 0 ? frame.height / p->height : 1.0f;
+    for (int i = 0; i < p->numBlobs; i++)
+    {
+        Blob *blob = &p->blobs[i];
+        Rectangle box = {frame.x + blob->bounds.x * scaleX, frame.y + blob->bounds.y * scaleY, blob->bounds.width * scaleX, blob->bounds.height * scaleY};
+        DrawRectangleLinesEx(box, 2, LIME);
+        if (blob->id != 0)
+            DrawHudText(blob->label, box.x, box.y - 22, 20, LIME);
+    }
+    if (p->focusText[0] != '\0')
+        DrawHudText(p->focusText, screenWidth - 160, screenHeight - 50, 20, WHITE);
+}
+
+void UnloadPipeline(void)
+{
+    Pipeline *p = &pipeline;
+    for (int i = 0; i < PIPELINE_POOL_SIZE; i++)
+        MemFree(p->pool[i].data);
+    for (int i = 0; i <= PROXY_LEVEL; i++)
+        MemFree(p->proxies[i].pixels);
+    ReleasePipelineTextures(p);
+    *p = (Pipeline){0, true};
+}
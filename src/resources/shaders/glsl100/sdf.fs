@@ -0,0 +1,23 @@
+#version 100
+#extension GL_OES_standard_derivatives : enable
+
+precision mediump float;
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+void main()
+{
+    // The atlas alpha holds the distance to the glyph outline, 0.5 is the outline itself
+    float distance = texture2D(texture0, fragTexCoord).a - 0.5;
+    // Smooth over about one screen pixel, whatever size the text is drawn at
+    float smoothing = max(fwidth(distance), 0.0001)*0.7;
+    float alpha = smoothstep(-smoothing, smoothing, distance);
+
+    gl_FragColor = vec4(fragColor.rgb, fragColor.a*alpha)*colDiffuse;
+}
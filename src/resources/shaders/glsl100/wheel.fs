@@ -0,0 +1,56 @@
+#version 100
+
+// Angles near 360 degrees and radii in pixels need more than the 10-bit mantissa of mediump
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values
+uniform float quadSize;        // Side of the square the wheel is drawn on, in pixels
+uniform int segmentCount;
+uniform float gapAngle;        // Degrees left empty between two segments
+uniform float discRadius;      // Background disc
+uniform float innerRadius;     // Segments
+uniform float outerRadius;
+uniform float selectionRadius; // Inner edge of the selection arc, which ends at outerRadius
+uniform int selection;         // Selected segment, -1 for none
+uniform vec4 discColor;
+uniform vec4 segmentColor;
+uniform vec4 selectionColor;
+
+// Composite a layer over the premultiplied result, coverage from a signed distance in pixels
+vec4 Over(vec4 result, vec4 color, float distance)
+{
+    float alpha = color.a*clamp(0.5 - distance, 0.0, 1.0);
+    return vec4(color.rgb*alpha + result.rgb*(1.0 - alpha), alpha + result.a*(1.0 - alpha));
+}
+
+void main()
+{
+    vec2 p = (fragTexCoord - 0.5)*quadSize; // Pixels from the wheel center, y down
+    float radius = length(p);
+
+    // Angles run like the segment centers in wheelmath.h: 0 points down, increasing towards +x
+    float angle = degrees(atan(p.x, p.y));
+    if (angle < 0.0) angle += 360.0;
+    float span = 360.0/float(segmentCount);
+    float nearest = floor(angle/span + 0.5);
+    float segment = mod(nearest, float(segmentCount));
+    float halfUsed = (span - gapAngle)*0.5;
+    // Distance to the closest segment side, measured across the ray at the current radius
+    float side = radius*sin(radians(clamp(abs(angle - nearest*span) - halfUsed, -90.0, 90.0)));
+
+    vec4 result = vec4(0.0);
+    result = Over(result, discColor, radius - discRadius);
+    result = Over(result, segmentColor, max(max(innerRadius - radius, radius - outerRadius), side));
+    if (int(segment) == selection)
+        result = Over(result, selectionColor, max(max(selectionRadius - radius, radius - outerRadius), side));
+
+    gl_FragColor = vec4(result.rgb/max(result.a, 0.0001), result.a)*fragColor;
+}
@@ -0,0 +1,23 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // The atlas alpha holds the distance to the glyph outline, 0.5 is the outline itself
+    float distance = texture(texture0, fragTexCoord).a - 0.5;
+    // Smooth over about one screen pixel, whatever size the text is drawn at
+    float smoothing = max(fwidth(distance), 0.0001)*0.7;
+    float alpha = smoothstep(-smoothing, smoothing, distance);
+
+    finalColor = vec4(fragColor.rgb, fragColor.a*alpha)*colDiffuse;
+}
@@ -0,0 +1,202 @@
+// Signed-distance-field HUD text
+// The atlas is generated once at startup from raylib's default font, so the HUD keeps its look but stays crisp at any size.
+// Labels are queued while drawing and flushed in one batch with a single shader at the end of the frame.
+// Until LoadHudFontStep() has finished they are drawn with the default font, so the first frame does not wait for the atlas.
+
+#if defined(PLATFORM_WEB)
+#define GLSL_VERSION 100
+#else
+#define GLSL_VERSION 330
+#endif
+
+#define HUD_FONT_SCALE 6  // Atlas pixels per default font pixel
+#define HUD_FONT_SPREAD 6 // Atlas pixels the distance field extends past each glyph outline
+#define MAX_HUD_LABELS 64
+
+typedef struct HudLabel
+{
+    const char *text; // Must stay valid until FlushHudText()
+    Vector2 position;
+    float fontSize;
+    Color color;
+} HudLabel;
+
+static Font hudFont = {0};
+static Shader hudFontShader = {0};
+static HudLabel hudLabels[MAX_HUD_LABELS];
+static int numHudLabels = 0;
+static int numHudGlyphs = 0; // Distance fields generated so far by LoadHudFontStep()
+
+#define EDT_INFINITY 1e20f
+
+// Squared Euclidean distance transform of n samples spaced step apart, in place (Felzenszwalb & Huttenlocher).
+// f holds 0 on the feature and EDT_INFINITY elsewhere, d, v and z are scratch space for n, n and n + 1 values.
+static void DistanceTransform1D(float *f, int n, int step, float *d, int *v, float *z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -EDT_INFINITY;
+    z[1] = EDT_INFINITY;
+    for (int q = 1; q < n; q++)
+    {
+        // Intersection of the parabola rooted at q with the rightmost one of the lower envelope
+        float s;
+        do
+        {
+            int r = v[k];
+            s = ((f[q * step] + q * q) - (f[r * step] + r * r)) / (2 * q - 2 * r);
+        } while (s <= z[k] && --k >= 0);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = EDT_INFINITY;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k + 1] < q)
+            k++;
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k] * step];
+    }
+    for (int q = 0; q < n; q++)
+        f[q * step] = d[q];
+}
+
+// Squared distance of every pixel to the nearest pixel set in the field, columns then rows
+static void DistanceTransform2D(float *field, int width, int height, float *d, int *v, float *z)
+{
+    for (int x = 0; x < width; x++)
+        DistanceTransform1D(field + x, height, width, d, v, z);
+    for (int y = 0; y < height; y++)
+        DistanceTransform1D(field + y * width, width, 1, d, v, z);
+}
+
+// Distance field of a default font glyph, in linear time from two exact distance transforms at atlas resolution
+static Image GenGlyphDistanceField(Image glyph)
+{
+    Color *pixels = LoadImageColors(glyph);
+    int width = glyph.width * HUD_FONT_SCALE + 2 * HUD_FONT_SPREAD;
+    int height = glyph.height * HUD_FONT_SCALE + 2 * HUD_FONT_SPREAD;
+    int longest = width > height ? width : height;
+    float *toInside = (float *)MemAlloc(width * height * sizeof(float));
+    float *toOutside = (float *)MemAlloc(width * height * sizeof(float));
+    float *d = (float *)MemAlloc(longest * sizeof(float));
+    int *v = (int *)MemAlloc(longest * sizeof(int));
+    float *z = (float *)MemAlloc((longest + 1) * sizeof(float));
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            // Default font pixel under the atlas pixel's center, the spread around the glyph counts as empty
+            int ix = (int)floorf((x + 0.5f - HUD_FONT_SPREAD) / HUD_FONT_SCALE);
+            int iy = (int)floorf((y + 0.5f - HUD_FONT_SPREAD) / HUD_FONT_SCALE);
+            bool inside = ix >= 0 && iy >= 0 && ix < glyph.width && iy < glyph.height && pixels[iy * glyph.width + ix].a > 127;
+            toInside[y * width + x] = inside ? 0.0f : EDT_INFINITY;
+            toOutside[y * width + x] = inside ? EDT_INFINITY : 0.0f;
+        }
+    }
+    DistanceTransform2D(toInside, width, height, d, v, z);
+    DistanceTransform2D(toOutside, width, height, d, v, z);
+
+    unsigned char *data = (unsigned char *)MemAlloc(width * height);
+    for (int i = 0; i < width * height; i++)
+    {
+        // Signed distance to the outline in atlas pixels, which lies half a pixel short of the nearest opposite center
+        float distance = toInside[i] == 0.0f ? sqrtf(toOutside[i]) - 0.5f : 0.5f - sqrtf(toInside[i]);
+        float value = 0.5f + distance / (2.0f * HUD_FONT_SPREAD);
+        data[i] = (unsigned char)(255.0f * fminf(fmaxf(value, 0.0f), 1.0f));
+    }
+
+    MemFree(toInside);
+    MemFree(toOutside);
+    MemFree(d);
+    MemFree(v);
+    MemFree(z);
+    UnloadImageColors(pixels);
+    return (Image){data, width, height, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+}
+
+// Build the atlas one glyph per call, so staged startup can spread it over frames. True once the font is ready.
+bool LoadHudFontStep(void)
+{
+    Font defaultFont = GetFontDefault();
+    if (hudFont.glyphs == NULL)
+    {
+        hudFont.baseSize = defaultFont.baseSize * HUD_FONT_SCALE;
+        hudFont.glyphCount = defaultFont.glyphCount;
+        hudFont.glyphPadding = 0;
+        hudFont.glyphs = (GlyphInfo *)MemAlloc(hudFont.glyphCount * sizeof(GlyphInfo));
+        numHudGlyphs = 0;
+    }
+    if (numHudGlyphs < hudFont.glyphCount)
+    {
+        int i = numHudGlyphs++;
+        GlyphInfo glyph = defaultFont.glyphs[i];
+        // The default font leaves advanceX at 0 and advances by the glyph width instead
+        int advance = glyph.advanceX != 0 ? glyph.advanceX : (int)defaultFont.recs[i].width;
+        hudFont.glyphs[i] = (GlyphInfo){glyph.value,
+                                        glyph.offsetX * HUD_FONT_SCALE - HUD_FONT_SPREAD,
+                                        glyph.offsetY * HUD_FONT_SCALE - HUD_FONT_SPREAD,
+                                        advance * HUD_FONT_SCALE,
+                                        GenGlyphDistanceField(glyph.image)};
+        return false;
+    }
+
+    Image atlas = GenImageFontAtlas(hudFont.glyphs, &hudFont.recs, hudFont.glyphCount, hudFont.baseSize, 0, 0);
+    hudFont.texture = LoadTextureFromImage(atlas);
+    SetTextureFilter(hudFont.texture, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(atlas);
+
+    hudFontShader = LoadShader(0, TextFormat("resources/shaders/glsl%i/sdf.fs", GLSL_VERSION));
+    return true;
+}
+
+void UnloadHudFont(void)
+{
+    UnloadShader(hudFontShader);
+    UnloadFont(hudFont);
+    hudFont = (Font){0};
+    numHudGlyphs = 0;
+}
+
+// Same metrics as MeasureText() with the default font
+int MeasureHudText(const char *text, int fontSize)
+{
+    if (hudFont.texture.id == 0)
+        return MeasureText(text, fontSize);
+    if (fontSize < 10)
+        fontSize = 10;
+    return (int)MeasureTextEx(hudFont, text, fontSize, fontSize / 10).x;
+}
+
+void FlushHudText(void)
+{
+    if (numHudLabels == 0)
+        return;
+    if (hudFont.texture.id == 0)
+    {
+        for (int i = 0; i < numHudLabels; i++)
+            DrawText(hudLabels[i].text, hudLabels[i].position.x, hudLabels[i].position.y, hudLabels[i].fontSize, hudLabels[i].color);
+        numHudLabels = 0;
+        return;
+    }
+    BeginShaderMode(hudFontShader);
+    for (int i = 0; i < numHudLabels; i++)
+    {
+        HudLabel label = hudLabels[i];
+        DrawTextEx(hudFont, label.text, label.position, label.fontSize, (int)label.fontSize / 10, label.color);
+    }
+    EndShaderMode();
+    numHudLabels = 0;
+}
+
+// Queue a label, drop-in for DrawText()
+void DrawHudText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (numHudLabels == MAX_HUD_LABELS)
+        FlushHudText();
+    if (fontSize < 10)
+        fontSize = 10;
+    hudLabels[numHudLabels++] = (HudLabel){text, (Vector2){posX, posY}, fontSize, color};
+}
@@ -0,0 +1,140 @@
+// Offscreen golden-image rendering of scripted wheel states.
+// Build natively with -DRENDER_SNAPSHOTS and run from src/ (use xvfb-run on a headless box,
+// Mesa's llvmpipe then acts as the software rasterizer). Pass --update to write the references, a state
+// without one fails otherwise.
+
+#define SNAPSHOT_DIR "snapshots"
+#define SNAPSHOT_CHANNEL_TOLERANCE 8    // Max difference per color channel before a pixel counts as changed
+#define SNAPSHOT_PIXEL_TOLERANCE 0.002f // Fraction of changed pixels allowed before a state fails
+#define SNAPSHOT_TIMING_FRAMES 60       // Frames rendered per state to average the render time
+
+typedef struct SnapshotState
+{
+    const char *name;
+    int header;    // headerSelection
+    int selection; // wheelSelection, NULL_VAL for none
+    int option;    // selectedWheelOptions entry of the selected segment
+} SnapshotState;
+
+static const SnapshotState snapshotStates[] = {
+    {"camera_idle", 0, NULL_VAL, 0},
+    {"camera_single", 0, 0, 0},
+    {"camera_burst", 0, 0, 1},
+    {"camera_flipx", 0, 1, 0},
+    {"camera_rot90", 0, 3, 1},
+    {"processing_idle", 1, NULL_VAL, 0},
+    {"processing_blobtrack", 1, 3, 1},
+    {"processing_focus", 1, 4, 0},
+    {"tools_audio_off", 2, 0, 2},
+    {"tools_help", 2, 1, 0},
+};
+
+// Draw the same layers DrawGame() draws while LB is held, without reading the gamepad
+static void DrawSnapshotState(SnapshotState state)
+{
+    headerSelection = state.header;
+    wheelSelection = state.selection;
+    memset(selectedWheelOptions, 0, sizeof(selectedWheelOptions)); // No option carries over from the previous state
+    if (state.selection != NULL_VAL)
+        selectedWheelOptions[state.header][state.selection] = state.option;
+    framesCounter = 0;
+
+    ClearBackground(RAYWHITE);
+    DrawManagedTexture(grayscaleTestTex, screenRect, WHITE);
+    DrawHeader();
+    DrawWheel();
+    DrawWheelSelection();
+    FlushHudText();
+}
+
+// Fraction of pixels whose channels differ by more than SNAPSHOT_CHANNEL_TOLERANCE
+static float CompareSnapshot(Image image, Image reference)
+{
+    if (image.width != reference.width || image.height != reference.height)
+        return 1.0f;
+
+    Color *a = LoadImageColors(image);
+    Color *b = LoadImageColors(reference);
+    int count = image.width * image.height;
+    int changed = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (abs(a[i].r - b[i].r) > SNAPSHOT_CHANNEL_TOLERANCE || abs(a[i].g - b[i].g) > SNAPSHOT_CHANNEL_TOLERANCE ||
+            abs(a[i].b - b[i].b) > SNAPSHOT_CHANNEL_TOLERANCE || abs(a[i].a - b[i].a) > SNAPSHOT_CHANNEL_TOLERANCE)
+            changed++;
+    }
+    UnloadImageColors(a);
+    UnloadImageColors(b);
+    return (float)changed / count;
+}
+
+// Render every scripted state, compare against the references and record the render times.
+// Returns the number of failed states.
+int RunSnapshots(bool update)
+{
+    RenderTexture2D target = LoadRenderTexture(screenWidth, screenHeight);
+    FILE *timings = fopen(SNAPSHOT_DIR "/timings.csv", "w");
+    if (timings != NULL)
+        fprintf(timings, "state,ms_per_frame,changed_fraction,result\n");
+
+    int numStates = sizeof(snapshotStates) / sizeof(snapshotStates[0]);
+    int failures = 0;
+    for (int i = 0; i < numStates; i++)
+    {
+        SnapshotState state = snapshotStates[i];
+
+        // Average several frames, the readback at the end waits for the GPU to finish them all
+        double start = GetTime();
+        for (int f = 0; f < SNAPSHOT_TIMING_FRAMES; f++)
+        {
+            BeginTextureMode(target);
+            DrawSnapshotState(state);
+            EndTextureMode();
+        }
+        Image image = LoadImageFromTexture(target.texture);
+        double msPerFrame = (GetTime() - start) * 1000.0 / SNAPSHOT_TIMING_FRAMES;
+        ImageFlipVertical(&image); // Render textures are stored bottom-up
+
+        const char *path = TextFormat(SNAPSHOT_DIR "/%s.png", state.name);
+        const char *result;
+        float changed = 0.0f;
+        if (update)
+        {
+            ExportImage(image, path);
+            result = "WRITTEN";
+        }
+        else if (!FileExists(path))
+        {
+            // A missing reference fails, otherwise a checkout without them would always pass
+            ExportImage(image, TextFormat(SNAPSHOT_DIR "/%s.actual.png", state.name));
+            result = "MISSING";
+            failures++;
+        }
+        else
+        {
+            Image reference = LoadImage(path);
+            ImageFormat(&reference, image.format);
+            changed = CompareSnapshot(image, reference);
+            UnloadImage(reference);
+            if (changed > SNAPSHOT_PIXEL_TOLERANCE)
+            {
+                ExportImage(image, TextFormat(SNAPSHOT_DIR "/%s.actual.png", state.name));
+                result = "FAILED";
+                failures++;
+            }
+            else
+                result = "OK";
+        }
+        UnloadImage(image);
+
+        printf("%-24s %8.3f ms  %6.3f%% changed  %s\n", state.name, msPerFrame, changed * 100.0f, result);
+        if (timings != NULL)
+            fprintf(timings, "%s,%.3f,%.5f,%s\n", state.name, msPerFrame, changed, result);
+    }
+
+    if (timings != NULL)
+        fclose(timings);
+    UnloadRenderTexture(target);
+    printf("%d of %d snapshot states failed\n", failures, numStates);
+    return failures;
+}
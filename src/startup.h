@@ -0,0 +1,88 @@
+// Staged startup
+// Only the window is created before the first frame, which shows the "Press any button" prompt with the default
+// font. The remaining steps run in priority order on the idle frames that follow, and all at once as soon as a gamepad
+// connects. Every phase is timed and logged.
+// The budget is checked before each call, so an idle frame stops starting work once STARTUP_FRAME_BUDGET is spent.
+// One call per frame always runs to keep startup moving, and a call cannot be interrupted: the HUD font does one
+// glyph per call, but the other steps are single calls (decoding fire.png, opening the audio device) and can overrun.
+
+#define STARTUP_FRAME_BUDGET 0.008 // Seconds of steps per idle frame
+
+typedef struct StartupStep
+{
+    const char *name;
+    bool (*run)(void); // True once the step is done, called again on later calls otherwise
+} StartupStep;
+
+// Highest priority first: everything the wheel needs, then the background, then sound
+static const StartupStep startupSteps[] = {
+    {"HUD font", InitHudFontStep},
+    {"Wheel shader", InitWheelShaderStep},
+    {"Frame source", InitFrameSourceStep},
+    {"Test texture", InitTestTextureStep},
+    {"Gray texture", InitGrayscaleTextureStep},
+    {"Audio device", InitAudioStep},
+    {"Music", InitMusicStep},
+};
+
+#define NUM_STARTUP_STEPS (int)(sizeof(startupSteps) / sizeof(startupSteps[0]))
+
+typedef struct Startup
+{
+    int nextStep;
+    double stepMs; // Time spent in the next step so far
+    bool firstFrameShown;
+    int frames;    // Frames that ran steps
+    double workMs; // Time spent in steps
+} Startup;
+
+static Startup startup = {0};
+
+// Call right after InitWindow(), raylib's clock starts with the window
+void BeginStartup(void)
+{
+    TraceLog(LOG_INFO, "STARTUP: Window open after %.2f ms", GetTime() * 1000.0);
+}
+
+bool IsStartupDone(void)
+{
+    return startup.nextStep == NUM_STARTUP_STEPS;
+}
+
+// Run the next steps within the frame budget, or every remaining one with finish set
+void UpdateStartup(bool finish)
+{
+    if (IsStartupDone() || (!startup.firstFrameShown && !finish)) // Nothing may delay the first frame
+        return;
+
+    double frameStart = GetTime();
+    startup.frames++;
+    do
+    {
+        const StartupStep *step = &startupSteps[startup.nextStep];
+        double start = GetTime();
+        bool done = step->run();
+        double ms = (GetTime() - start) * 1000.0;
+        startup.workMs += ms;
+        startup.stepMs += ms;
+        if (done)
+        {
+            TraceLog(LOG_INFO, "STARTUP: %-14s %8.2f ms", step->name, startup.stepMs);
+            startup.nextStep++;
+            startup.stepMs = 0.0;
+        }
+    } while (!IsStartupDone() && (finish || GetTime() - frameStart < STARTUP_FRAME_BUDGET));
+
+    if (IsStartupDone())
+        TraceLog(LOG_INFO, "STARTUP: Ready after %.2f ms, %.2f ms of steps over %d frames%s", GetTime() * 1000.0,
+                 startup.workMs, startup.frames, finish ? ", finished early for a gamepad" : "");
+}
+
+// Call after the frame was drawn
+void EndStartupFrame(void)
+{
+    if (startup.firstFrameShown)
+        return;
+    startup.firstFrameShown = true;
+    TraceLog(LOG_INFO, "STARTUP: First frame after %.2f ms", GetTime() * 1000.0);
+}
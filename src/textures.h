@@ -0,0 +1,256 @@
+// Texture residency manager
+// Owns every GPU texture, keeps track of its bytes and drops textures that were not drawn recently
+// when the VRAM budget is exceeded: first to half resolution, then entirely. Every texture is uploaded from a
+// decoded source image its owner keeps in memory, so downscaling and rebuilding a dropped texture the next time
+// it is used never decode a file again. Streaming textures have no source and are updated in place with
+// UpdateManagedTexture(). They count toward the budget like the others: a streaming texture that does not fit is
+// refused, and an idle one is dropped entirely and recreated by its next update. Invalid handles draw a blank texture.
+
+#define MAX_MANAGED_TEXTURES 32
+#define DEFAULT_TEXTURE_BUDGET (48 * 1024 * 1024) // Bytes
+#define TEXTURE_IDLE_FRAMES 120                   // Frames without a draw before a texture may be downscaled or evicted
+#define MAX_TEXTURE_DOWNSCALE 2                   // Halvings tried before evicting
+
+typedef int TextureHandle;
+
+typedef struct ManagedTexture
+{
+    bool used;
+    const Image *source; // Owned by the caller, NULL for streaming textures
+    bool mipmaps;
+    bool resident;
+    int downscale;     // Number of halvings of the source image currently uploaded
+    int width, height; // Of a streaming texture, kept while it is dropped
+    Texture2D texture;
+    size_t bytes;
+    unsigned int lastUsedFrame;
+} ManagedTexture;
+
+static ManagedTexture managedTextures[MAX_MANAGED_TEXTURES];
+static size_t textureBudget = DEFAULT_TEXTURE_BUDGET;
+static size_t textureMemory = 0;
+static unsigned int textureFrame = 0;
+static Texture2D blankTexture = {0}; // Drawn for invalid handles, created on first use
+
+static size_t TextureBytes(Texture2D texture)
+{
+    size_t bytes = GetPixelDataSize(texture.width, texture.height, texture.format);
+    return texture.mipmaps > 1 ? bytes * 4 / 3 : bytes; // A full mip chain adds a third
+}
+
+static void UploadManagedTexture(ManagedTexture *t, int downscale)
+{
+    if (downscale > 0)
+    {
+        MemCategoryPush(MEM_IMAGES);
+        Image image = ImageCopy(*t->source);
+        ImageResize(&image, image.width >> downscale, image.height >> downscale);
+        t->texture = LoadTextureFromImage(image);
+        UnloadImage(image);
+        MemCategoryPop();
+    }
+    else
+        t->texture = LoadTextureFromImage(*t->source);
+
+    if (t->mipmaps)
+    {
+        GenTextureMipmaps(&t->texture);
+        SetTextureFilter(t->texture, TEXTURE_FILTER_TRILINEAR);
+    }
+    else
+        SetTextureFilter(t->texture, TEXTURE_FILTER_BILINEAR);
+    t->resident = true;
+    t->downscale = downscale;
+    t->bytes = TextureBytes(t->texture);
+    textureMemory += t->bytes;
+}
+
+// Recreate a streaming texture from RGBA8 pixels, blank when pixels is NULL
+static void UploadStreamingTexture(ManagedTexture *t, const void *pixels)
+{
+    if (pixels != NULL)
+        t->texture = LoadTextureFromImage((Image){(void *)pixels, t->width, t->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8});
+    else
+    {
+        Image blank = GenImageColor(t->width, t->height, BLACK);
+        t->texture = LoadTextureFromImage(blank);
+        UnloadImage(blank);
+    }
+    SetTextureFilter(t->texture, TEXTURE_FILTER_BILINEAR);
+    t->resident = true;
+    t->bytes = TextureBytes(t->texture);
+    textureMemory += t->bytes;
+}
+
+static void ReleaseManagedTexture(ManagedTexture *t)
+{
+    if (!t->resident)
+        return;
+    UnloadTexture(t->texture);
+    textureMemory -= t->bytes;
+    t->bytes = 0;
+    t->resident = false;
+}
+
+// Register a texture and upload it right away, mipmaps are worth it for textures drawn scaled down.
+// source must stay valid until the texture is unloaded.
+TextureHandle LoadManagedTexture(const Image *source, bool mipmaps)
+{
+    for (int i = 0; i < MAX_MANAGED_TEXTURES; i++)
+    {
+        if (managedTextures[i].used)
+            continue;
+        managedTextures[i] = (ManagedTexture){true, source, mipmaps};
+        managedTextures[i].lastUsedFrame = textureFrame;
+        UploadManagedTexture(&managedTextures[i], 0);
+        return i;
+    }
+    TraceLog(LOG_WARNING, "TEXTURES: No free slot, raise MAX_MANAGED_TEXTURES");
+    return -1;
+}
+
+// Shrink or evict the least recently drawn idle textures until bytes more fit in the budget, false if they do not
+static bool EvictIdleTextures(size_t bytes)
+{
+    while (textureMemory + bytes > textureBudget)
+    {
+        ManagedTexture *oldest = NULL;
+        for (int i = 0; i < MAX_MANAGED_TEXTURES; i++)
+        {
+            ManagedTexture *t = &managedTextures[i];
+            if (!t->used || !t->resident || textureFrame - t->lastUsedFrame < TEXTURE_IDLE_FRAMES)
+                continue;
+            if (oldest == NULL || t->lastUsedFrame < oldest->lastUsedFrame)
+                oldest = t;
+        }
+        if (oldest == NULL) // Everything resident was drawn recently
+            return false;
+
+        // Streaming textures cannot be rebuilt from a source, they are dropped at once
+        int downscale = oldest->downscale + 1;
+        ReleaseManagedTexture(oldest);
+        if (oldest->source != NULL && downscale <= MAX_TEXTURE_DOWNSCALE)
+            UploadManagedTexture(oldest, downscale);
+    }
+    return true;
+}
+
+// Register a blank RGBA8 texture of the given size for pixels uploaded every frame, -1 if it does not fit the budget
+TextureHandle LoadStreamingTexture(int width, int height)
+{
+    size_t bytes = GetPixelDataSize(width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (!EvictIdleTextures(bytes))
+    {
+        TraceLog(LOG_WARNING, "TEXTURES: %dx%d streaming texture does not fit the budget (%.1f of %.1f MB in use)",
+                 width, height, textureMemory / (1024.0f * 1024.0f), textureBudget / (1024.0f * 1024.0f));
+        return -1;
+    }
+    for (int i = 0; i < MAX_MANAGED_TEXTURES; i++)
+    {
+        if (managedTextures[i].used)
+            continue;
+        ManagedTexture *t = &managedTextures[i];
+        *t = (ManagedTexture){true, NULL, false};
+        t->lastUsedFrame = textureFrame;
+        t->width = width;
+        t->height = height;
+        UploadStreamingTexture(t, NULL);
+        return i;
+    }
+    TraceLog(LOG_WARNING, "TEXTURES: No free slot, raise MAX_MANAGED_TEXTURES");
+    return -1;
+}
+
+// NULL for handles that failed to load or were unloaded
+static ManagedTexture *GetManagedTexture(TextureHandle handle)
+{
+    if (handle < 0 || handle >= MAX_MANAGED_TEXTURES || !managedTextures[handle].used)
+        return NULL;
+    return &managedTextures[handle];
+}
+
+// Replace all pixels of a streaming texture, RGBA8 in the size it was loaded with. Recreates it if it was dropped.
+void UpdateManagedTexture(TextureHandle handle, const void *pixels)
+{
+    ManagedTexture *t = GetManagedTexture(handle);
+    if (t == NULL || t->source != NULL)
+        return;
+    t->lastUsedFrame = textureFrame;
+    if (t->resident)
+        UpdateTexture(t->texture, pixels);
+    else
+        UploadStreamingTexture(t, pixels);
+}
+
+void UnloadManagedTexture(TextureHandle handle)
+{
+    ManagedTexture *t = GetManagedTexture(handle);
+    if (t == NULL)
+        return;
+    ReleaseManagedTexture(t);
+    t->used = false;
+}
+
+// Texture for drawing this frame, brought back to full resolution if it was downscaled or evicted.
+// Call it ahead of the frame that draws a texture to take the upload out of drawing.
+Texture2D UseTexture(TextureHandle handle)
+{
+    ManagedTexture *t = GetManagedTexture(handle);
+    if (t == NULL)
+    {
+        if (blankTexture.id == 0)
+        {
+            Image blank = GenImageColor(1, 1, BLANK);
+            blankTexture = LoadTextureFromImage(blank);
+            UnloadImage(blank);
+        }
+        return blankTexture;
+    }
+    t->lastUsedFrame = textureFrame;
+    if (t->source == NULL)
+    {
+        if (!t->resident) // Dropped and not updated since, blank until the next update
+            UploadStreamingTexture(t, NULL);
+    }
+    else if (!t->resident || t->downscale > 0)
+    {
+        ReleaseManagedTexture(t);
+        UploadManagedTexture(t, 0);
+    }
+    return t->texture;
+}
+
+// Draw a managed texture stretched over dest, whatever resolution it is resident at
+void DrawManagedTexture(TextureHandle handle, Rectangle dest, Color tint)
+{
+    Texture2D texture = UseTexture(handle);
+    DrawTexturePro(texture, (Rectangle){0, 0, texture.width, texture.height}, dest, (Vector2){0, 0}, 0, tint);
+}
+
+// Call once per frame, shrinks or evicts the least recently drawn idle textures until the budget is met
+void UpdateTextureResidency(void)
+{
+    textureFrame++;
+    EvictIdleTextures(0);
+}
+
+void SetTextureBudget(size_t bytes)
+{
+    textureBudget = bytes;
+}
+
+size_t GetTextureMemory(void)
+{
+    return textureMemory;
+}
+
+void UnloadManagedTextures(void)
+{
+    for (int i = 0; i < MAX_MANAGED_TEXTURES; i++)
+    {
+        ReleaseManagedTexture(&managedTextures[i]);
+        managedTextures[i].used = false;
+    }
+    UnloadTexture(blankTexture);
+    blankTexture = (Texture2D){0};
+}
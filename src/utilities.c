@@ -1,15 +1,16 @@
 #include "./functions.h"
 
+// Both return a static buffer that is overwritten by the next call, like raylib's TextFormat()
 char *IntToString(int num)
 {
-    char *str = (char *)malloc(10 * sizeof(char));
-    sprintf(str, "%d", num);
+    static char str[12];
+    snprintf(str, sizeof(str), "%d", num);
     return str;
 }
 
 char *FloatToString(float num)
 {
-    char *str = (char *)malloc(10 * sizeof(char));
-    sprintf(str, "%f", num);
+    static char str[48];
+    snprintf(str, sizeof(str), "%f", num);
     return str;
 }
\ No newline at end of file
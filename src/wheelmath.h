@@ -0,0 +1,75 @@
+// Wheel geometry shared by the game and src/benchmark.c, only depends on the raylib types
+
+#define WHEEL_SEGMENT_GAP 2.0 // Degrees left empty between two ring segments
+
+// Fill the start/end angles and icon centers of numSegments ring segments, returns half the used angle span
+float ComputeSegmentAngles(int numSegments, Vector2 wheelCenter, float wheelRadius,
+                           float *startAngles, float *endAngles, Vector2 *segmentCenters)
+{
+    float segmentAngleSpan = 360.0 / numSegments;
+    float halfUsedAngleSpan = (segmentAngleSpan - WHEEL_SEGMENT_GAP) / 2.0;
+    for (int i = 0; i < numSegments; i++)
+    {
+        startAngles[i] = i * segmentAngleSpan - halfUsedAngleSpan;
+        endAngles[i] = i * segmentAngleSpan + halfUsedAngleSpan;
+        float midAngle = (1 / 360.0) * PI * (startAngles[i] + endAngles[i] - 180.0);
+        segmentCenters[i] = (Vector2){wheelCenter.x + cos(midAngle) * wheelRadius * 0.8,
+                                      wheelCenter.y - sin(midAngle) * wheelRadius * 0.8};
+    }
+    return halfUsedAngleSpan;
+}
+
+// Index of the segment the stick points at, -1 if the stick is not pushed to the ring or points at a gap
+int StickToSegment(Vector2 stick, int numSegments, const float *startAngles, const float *endAngles, float halfUsedAngleSpan)
+{
+    // The stick has to reach the ring radius * 0.99
+    if (sqrt(pow(stick.x, 2) + pow(stick.y, 2)) <= 0.99)
+        return -1;
+
+    float angle = atan2(stick.y, stick.x) * 180 / PI - 90;
+    if (angle < 0)
+        angle += 360;
+    angle = abs((int)(360 - angle));
+
+    int segment = -1;
+    for (int i = 0; i < numSegments; i++)
+    {
+        // Determine if the angle points towards the ring segement and
+        // solve edge case crossing quadrant 4 -> quadrant 3
+        if ((angle >= startAngles[i] && angle <= endAngles[i]) ||
+            (i == 0 && angle > 360.0 - halfUsedAngleSpan && angle <= 360.0))
+            segment = i;
+    }
+    return segment;
+}
+
+// Positions of the LT/RT buttons beside a selected segment
+void TriggerButtonAnchors(Vector2 wheelCenter, float wheelRadius, Vector2 segmentCenter,
+                          float startAngle, float endAngle, Vector2 *lt, Vector2 *rt)
+{
+    // Find the intersection of the horizontal line through the segment center with the ring edges
+    float buttonProjection = -pow(segmentCenter.y, 2) + 2 * segmentCenter.y * wheelCenter.y - pow(wheelCenter.y, 2);
+    float buttonInner = sqrt(buttonProjection + pow(wheelRadius * 0.625, 2));
+    float buttonOuter = sqrt(buttonProjection + pow(wheelRadius, 2));
+    // Finally place the buttons depending on the angle of the segment
+    if (isnan(buttonInner)) // The line misses the inner edge, place the buttons on the segment sides instead
+    {
+        double r = wheelRadius * 0.8;
+        float ltAngle = (startAngle >= 0 && startAngle <= 180) ? startAngle : endAngle;
+        float rtAngle = (startAngle >= 0 && startAngle <= 180) ? endAngle : startAngle;
+        *lt = (Vector2){(int)(r * cos((ltAngle + 90.0) * PI / 180.0) + wheelCenter.x),
+                        (int)(r * sin((ltAngle + 90.0) * PI / 180.0) + wheelCenter.y)};
+        *rt = (Vector2){(int)(r * cos((rtAngle + 90.0) * PI / 180.0) + wheelCenter.x),
+                        (int)(r * sin((rtAngle + 90.0) * PI / 180.0) + wheelCenter.y)};
+    }
+    else if (segmentCenter.x > wheelCenter.x)
+    {
+        *lt = (Vector2){(int)(wheelCenter.x + (int)buttonInner), (int)segmentCenter.y};
+        *rt = (Vector2){(int)(wheelCenter.x + (int)buttonOuter), (int)segmentCenter.y};
+    }
+    else
+    {
+        *lt = (Vector2){(int)(wheelCenter.x - (int)buttonOuter), (int)segmentCenter.y};
+        *rt = (Vector2){(int)(wheelCenter.x - (int)buttonInner), (int)segmentCenter.y};
+    }
+}
@@ -0,0 +1,95 @@
+// Shader wheel renderer
+// Draws the background disc, the ring segments with their gaps and the selection arc from one fragment shader
+// on a single quad. Edges are anti-aliased analytically from their distance in pixels, so the window no longer
+// needs MSAA and the segment count costs next to nothing. Build with -DSHADER_WHEEL=0 for the DrawRing() wheel.
+
+#ifndef SHADER_WHEEL
+#define SHADER_WHEEL 1
+#endif
+
+// Wheel proportions of wheelRadius, shared with the DrawRing() wheel
+#define WHEEL_DISC_RADIUS 0.57f
+#define WHEEL_INNER_RADIUS 0.6f
+#define WHEEL_SELECTION_RADIUS 0.95f
+
+typedef struct WheelShader
+{
+    Shader shader;
+    Texture2D quad; // 1x1 white texture, so the quad's texture coordinates run from 0 to 1
+    int quadSizeLoc;
+    int segmentCountLoc;
+    int gapAngleLoc;
+    int discRadiusLoc;
+    int innerRadiusLoc;
+    int outerRadiusLoc;
+    int selectionRadiusLoc;
+    int selectionLoc;
+    int discColorLoc;
+    int segmentColorLoc;
+    int selectionColorLoc;
+} WheelShader;
+
+static WheelShader wheelShader = {0};
+
+static void SetWheelShaderColor(int loc, Color color)
+{
+    Vector4 value = ColorNormalize(color);
+    SetShaderValue(wheelShader.shader, loc, &value, SHADER_UNIFORM_VEC4);
+}
+
+static void SetWheelShaderFloat(int loc, float value)
+{
+    SetShaderValue(wheelShader.shader, loc, &value, SHADER_UNIFORM_FLOAT);
+}
+
+void LoadWheelShader(void)
+{
+    WheelShader *w = &wheelShader;
+    w->shader = LoadShader(0, TextFormat("resources/shaders/glsl%i/wheel.fs", GLSL_VERSION));
+    Image white = GenImageColor(1, 1, WHITE);
+    w->quad = LoadTextureFromImage(white);
+    UnloadImage(white);
+
+    w->quadSizeLoc = GetShaderLocation(w->shader, "quadSize");
+    w->segmentCountLoc = GetShaderLocation(w->shader, "segmentCount");
+    w->gapAngleLoc = GetShaderLocation(w->shader, "gapAngle");
+    w->discRadiusLoc = GetShaderLocation(w->shader, "discRadius");
+    w->innerRadiusLoc = GetShaderLocation(w->shader, "innerRadius");
+    w->outerRadiusLoc = GetShaderLocation(w->shader, "outerRadius");
+    w->selectionRadiusLoc = GetShaderLocation(w->shader, "selectionRadius");
+    w->selectionLoc = GetShaderLocation(w->shader, "selection");
+    w->discColorLoc = GetShaderLocation(w->shader, "discColor");
+    w->segmentColorLoc = GetShaderLocation(w->shader, "segmentColor");
+    w->selectionColorLoc = GetShaderLocation(w->shader, "selectionColor");
+
+    // The look of the wheel never changes, only its geometry and selection are set per draw
+    SetWheelShaderFloat(w->gapAngleLoc, WHEEL_SEGMENT_GAP);
+    SetWheelShaderColor(w->discColorLoc, Fade(BLACK, 0.5f));
+    SetWheelShaderColor(w->segmentColorLoc, Fade(BLACK, 0.8f));
+    SetWheelShaderColor(w->selectionColorLoc, Fade(MAROON, 0.8f));
+}
+
+void UnloadWheelShader(void)
+{
+    UnloadTexture(wheelShader.quad);
+    UnloadShader(wheelShader.shader);
+}
+
+// Draw the whole wheel, selection is the highlighted segment or -1
+void DrawWheelShader(Vector2 center, float radius, int numSegments, int selection)
+{
+    WheelShader *w = &wheelShader;
+    float quadSize = 2.0f * (radius + 1.0f); // One pixel of room for the anti-aliased outer edge
+    SetWheelShaderFloat(w->quadSizeLoc, quadSize);
+    SetShaderValue(w->shader, w->segmentCountLoc, &numSegments, SHADER_UNIFORM_INT);
+    SetWheelShaderFloat(w->discRadiusLoc, radius * WHEEL_DISC_RADIUS);
+    SetWheelShaderFloat(w->innerRadiusLoc, radius * WHEEL_INNER_RADIUS);
+    SetWheelShaderFloat(w->outerRadiusLoc, radius);
+    SetWheelShaderFloat(w->selectionRadiusLoc, radius * WHEEL_SELECTION_RADIUS);
+    SetShaderValue(w->shader, w->selectionLoc, &selection, SHADER_UNIFORM_INT);
+
+    BeginShaderMode(w->shader);
+    DrawTexturePro(w->quad, (Rectangle){0, 0, 1, 1},
+                   (Rectangle){center.x - quadSize / 2, center.y - quadSize / 2, quadSize, quadSize}, (Vector2){0, 0}, 0, WHITE);
+    EndShaderMode();
+}